@@ -34,6 +34,10 @@ class invalid_iterator : public exception {
 class container_is_empty : public exception {
 	/* __________________________ */
 };
+
+class capacity_exceeded : public exception {
+	/* __________________________ */
+};
 }
 
 #endif
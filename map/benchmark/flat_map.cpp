@@ -0,0 +1,81 @@
+// flat_map against sjtu::map with int keys and values: heap bytes per
+// element (from glibc's mallinfo2), time to build the table (flat_map
+// with the bulk insert), and the average latency of find() for random
+// keys, half of them present.
+//   g++ -std=c++17 -O2 -I.. flat_map.cpp -o flat_map && ./flat_map
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+#include "flat_map.hpp"
+#include "map.hpp"
+
+// 当前占用的堆内存。sjtu::vector 的分配器直接调用 malloc/realloc，不经过
+// operator new，所以向 malloc 询问（mmap 出的大块另计在 hblkhd 中）。
+static size_t Live() {
+  struct mallinfo2 mi = mallinfo2();
+  return mi.uordblks + mi.hblkhd;
+}
+
+template <class F>
+static double Ns(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::nano> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+struct Result {
+  double bytes, build_ms, find_ns;
+};
+
+// 键为奇数，查找的键一半命中一半不命中。
+template <class Map, class Build>
+static Result Run(const sjtu::vector<sjtu::pair<int, int>> &items,
+                  const sjtu::vector<int> &probes, Build build) {
+  size_t before = Live();
+  Map m;
+  double build_ns = Ns([&] { build(m, items); });
+  double bytes = double(Live() - before) / items.size();
+  long hits = 0;
+  double find_ns = Ns([&] {
+    for (int k : probes) hits += m.find(k) != m.end();
+  });
+  if (hits != long(probes.size() / 2)) std::exit(1);
+  return Result{bytes, build_ns / 1e6, find_ns / probes.size()};
+}
+
+int main() {
+  std::mt19937 rng(5);
+  std::printf("%9s | %26s | %26s\n", "", "sjtu::map", "flat_map");
+  std::printf("%9s | %7s %8s %9s | %7s %8s %9s\n", "elements", "B/elem",
+              "build ms", "find ns", "B/elem", "build ms", "find ns");
+  for (size_t n : {size_t(1000), size_t(100000), size_t(1000000)}) {
+    sjtu::vector<int> keys;
+    for (size_t i = 0; i < n; ++i) keys.push_back(int(2 * i + 1));
+    for (size_t i = n; i > 1; --i) std::swap(keys[i - 1], keys[rng() % i]);
+    sjtu::vector<sjtu::pair<int, int>> items;
+    for (size_t i = 0; i < n; ++i) items.push_back({keys[i], int(i)});
+    sjtu::vector<int> probes;
+    for (size_t i = 0; i < 1000000; ++i)
+      probes.push_back(i % 2 ? keys[rng() % n] : int(2 * (rng() % n)));
+
+    Result tree = Run<sjtu::map<int, int>>(
+        items, probes, [](sjtu::map<int, int> &m, const auto &items) {
+          for (const auto &e : items) m.insert(e);
+        });
+    Result flat = Run<sjtu::flat_map<int, int>>(
+        items, probes, [](sjtu::flat_map<int, int> &m, const auto &items) {
+          m.insert(items.begin(), items.end());
+        });
+    std::printf("%9zu | %7.1f %8.2f %9.1f | %7.1f %8.2f %9.1f\n", n,
+                tree.bytes, tree.build_ms, tree.find_ns, flat.bytes,
+                flat.build_ms, flat.find_ns);
+  }
+  return 0;
+}
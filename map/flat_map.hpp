@@ -0,0 +1,344 @@
+/**
+ * implement a container like std::map on top of sorted sjtu::vector
+ */
+#ifndef SJTU_FLAT_MAP_HPP
+#define SJTU_FLAT_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/src/vector.hpp"
+#include "exceptions.hpp"
+#include "utility.hpp"
+
+namespace sjtu {
+/**
+ * an associative container with the interface of sjtu::map that keeps its
+ * elements sorted by key in sjtu::vector instead of a tree node each.
+ * the keys live in one contiguous array, so a lookup is a binary search
+ * touching a few cache lines and iteration streams through memory; in
+ * exchange insert() and erase() shift the following elements, which makes
+ * flat_map fit tables that are built once (best with the bulk insert) and
+ * then mostly read.
+ *
+ * *it is a proxy pair<const Key &, T &>; it->first and it->second work as
+ * with map. inserting or erasing an element invalidates every iterator.
+ */
+template <class Key, class T, class Compare = std::less<Key> >
+class flat_map {
+ public:
+  using value_type = pair<const Key, T>;
+  using reference = pair<const Key &, T &>;
+  using const_reference = pair<const Key &, const T &>;
+
+ private:
+  // vector<bool> 按位存储，取不到 bool &，所以键和值都包一层再放进 vector.
+  template <class U>
+  struct Slot {
+    U value;
+  };
+
+  Compare lt;
+  vector<Slot<Key> > keys;
+  vector<Slot<T> > values;  // 与 keys 按下标一一对应。
+
+  // 让 it->first 可以作用在代理对象上。
+  template <class Ref>
+  class Arrow {
+    Ref ref;
+
+   public:
+    Arrow(const Ref &ref) : ref(ref) {}
+    const Ref *operator->() const { return &ref; }
+  };
+
+  // 键与值都能无异常地移动时才移动，否则拷贝，使合并失败时原内容不变。
+  static constexpr bool nothrow_move =
+      std::is_nothrow_move_constructible<Key>::value &&
+      std::is_nothrow_move_constructible<T>::value;
+  template <class U>
+  static std::conditional_t<nothrow_move, U &&, const U &> Take(U &x) {
+    return std::move(x);
+  }
+
+  // 第一个不小于 key 的下标。
+  size_t LowerBound(const Key &key) const {
+    const Slot<Key> *p = keys.data();
+    return std::lower_bound(p, p + keys.size(), key,
+                            [this](const Slot<Key> &s, const Key &k) {
+                              return lt(s.value, k);
+                            }) -
+           p;
+  }
+  // key 所在的下标，不存在时为 size().
+  size_t Find(const Key &key) const {
+    size_t i = LowerBound(key);
+    return i < keys.size() && !lt(key, keys[i].value) ? i : keys.size();
+  }
+  // 在下标 ind 处插入一个元素；值插入失败时撤销键的插入。
+  void Insert(size_t ind, const Key &key, Slot<T> &&slot) {
+    keys.insert(ind, Slot<Key>{key});
+    try {
+      values.insert(ind, std::move(slot));
+    } catch (...) {
+      keys.erase(ind);
+      throw;
+    }
+  }
+
+ public:
+  /**
+   * see BidirectionalIterator at CppReference for help.
+   *
+   * if there is anything wrong throw invalid_iterator.
+   *     like it = map.begin(); --it;
+   *       or it = map.end(); ++end();
+   */
+  class const_iterator;
+  class iterator {
+    friend class flat_map;
+    friend class const_iterator;
+    flat_map *source{nullptr};
+    size_t at{0};
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename flat_map::value_type;
+    using pointer = Arrow<typename flat_map::reference>;
+    using reference = typename flat_map::reference;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    iterator() = default;
+    iterator(flat_map *source, size_t at) : source{source}, at{at} {}
+
+    iterator operator++(int) {
+      iterator tmp = *this;
+      operator++();
+      return tmp;
+    }
+    iterator &operator++() {
+      if (at >= source->size()) throw invalid_iterator{};  // end() + 1
+      return ++at, *this;
+    }
+    iterator operator--(int) {
+      iterator tmp = *this;
+      operator--();
+      return tmp;
+    }
+    iterator &operator--() {
+      if (!at) throw invalid_iterator{};  // begin() - 1
+      return --at, *this;
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+    reference operator*() const {
+      return reference(source->keys[at].value, source->values[at].value);
+    }
+    pointer operator->() const { return pointer(**this); }
+  };
+  class const_iterator {
+    friend class flat_map;
+    friend class iterator;
+    const flat_map *source{nullptr};
+    size_t at{0};
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename flat_map::value_type;
+    using pointer = Arrow<typename flat_map::const_reference>;
+    using reference = typename flat_map::const_reference;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    const_iterator() = default;
+    const_iterator(const iterator &other)
+        : source{other.source}, at{other.at} {}
+    const_iterator(const flat_map *source, size_t at)
+        : source{source}, at{at} {}
+
+    const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      operator++();
+      return tmp;
+    }
+    const_iterator &operator++() {
+      if (at >= source->size()) throw invalid_iterator{};  // end() + 1
+      return ++at, *this;
+    }
+    const_iterator operator--(int) {
+      const_iterator tmp = *this;
+      operator--();
+      return tmp;
+    }
+    const_iterator &operator--() {
+      if (!at) throw invalid_iterator{};  // begin() - 1
+      return --at, *this;
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+    reference operator*() const {
+      return reference(source->keys[at].value, source->values[at].value);
+    }
+    pointer operator->() const { return pointer(**this); }
+  };
+
+  flat_map() = default;
+  /**
+   * builds the map from [first, last) with the bulk insert.
+   */
+  template <class InputIt, class = std::enable_if_t<
+                               !std::is_integral<InputIt>::value> >
+  flat_map(InputIt first, InputIt last) {
+    insert(first, last);
+  }
+
+  /**
+   * access specified element with bounds checking
+   * Returns a reference to the mapped value of the element with key equivalent
+   * to key. If no such element exists, an exception of type
+   * `index_out_of_bound'
+   */
+  T &at(const Key &key) {
+    size_t i = Find(key);
+    if (i == size()) throw index_out_of_bound{};
+    return values[i].value;
+  }
+  const T &at(const Key &key) const {
+    size_t i = Find(key);
+    if (i == size()) throw index_out_of_bound{};
+    return values[i].value;
+  }
+  /**
+   * access specified element
+   * Returns a reference to the value that is mapped to a key equivalent to key,
+   *   performing an insertion if such key does not already exist.
+   */
+  T &operator[](const Key &key) {
+    size_t i = LowerBound(key);
+    if (i == size() || lt(key, keys[i].value)) Insert(i, key, Slot<T>{T()});
+    return values[i].value;
+  }
+  /**
+   * behave like at() throw index_out_of_bound if such key does not exist.
+   */
+  const T &operator[](const Key &key) const { return at(key); }
+
+  iterator begin() { return {this, 0}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator cbegin() const { return {this, 0}; }
+  iterator end() { return {this, size()}; }
+  const_iterator end() const { return {this, size()}; }
+  const_iterator cend() const { return {this, size()}; }
+
+  bool empty() const { return keys.empty(); }
+  size_t size() const { return keys.size(); }
+  void clear() { keys.clear(), values.clear(); }
+  /**
+   * reserves room for n elements, so that inserting up to n elements
+   * does not reallocate.
+   */
+  void reserve(const size_t &n) { keys.reserve(n), values.reserve(n); }
+  void shrink_to_fit() { keys.shrink_to_fit(), values.shrink_to_fit(); }
+
+  /**
+   * insert an element.
+   * return a pair, the first of the pair is
+   *   the iterator to the new element (or the element that prevented the
+   * insertion), the second one is true if insert successfully, or false.
+   */
+  pair<iterator, bool> insert(const value_type &value) {
+    size_t i = LowerBound(value.first);
+    if (i < size() && !lt(value.first, keys[i].value))
+      return {{this, i}, false};
+    Insert(i, value.first, Slot<T>{value.second});
+    return {{this, i}, true};
+  }
+  /**
+   * inserts the elements of [first, last) whose keys are not in the map yet;
+   * of several equal keys in the range the first one wins, as with calling
+   * insert() on each. the new elements are sorted on their own and merged
+   * with the existing ones in a single pass: O(n + m log m) for m new
+   * elements instead of O(n m) shifting. if copying an element throws, the
+   * map is left unchanged.
+   */
+  template <class InputIt, class = std::enable_if_t<
+                               !std::is_integral<InputIt>::value> >
+  void insert(InputIt first, InputIt last) {
+    vector<Slot<Key> > new_keys;
+    vector<Slot<T> > new_values;
+    for (; first != last; ++first) {
+      auto &&e = *first;
+      new_keys.push_back(Slot<Key>{e.first});
+      new_values.push_back(Slot<T>{e.second});
+    }
+    size_t m = new_keys.size();
+    if (!m) return;
+    vector<size_t> order;
+    order.reserve(m);
+    for (size_t j = 0; j < m; ++j) order.push_back(j);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return lt(new_keys[a].value, new_keys[b].value);
+    });
+
+    vector<Slot<Key> > k;
+    vector<Slot<T> > v;
+    k.reserve(size() + m), v.reserve(size() + m);
+    // 空间已经预留，合并中只有拷贝可能抛出异常，而那时原内容尚未被移走。
+    size_t i = 0;
+    for (size_t j : order) {
+      const Key &key = new_keys[j].value;
+      for (; i < size() && lt(keys[i].value, key); ++i) {
+        k.push_back(Take(keys[i]));
+        v.push_back(Take(values[i]));
+      }
+      if (i < size() && !lt(key, keys[i].value)) continue;  // 已经存在。
+      if (!k.empty() && !lt(k.back().value, key)) continue;  // 区间内重复。
+      k.push_back(Take(new_keys[j]));
+      v.push_back(Take(new_values[j]));
+    }
+    for (; i < size(); ++i) {
+      k.push_back(Take(keys[i]));
+      v.push_back(Take(values[i]));
+    }
+    keys = std::move(k), values = std::move(v);
+  }
+  /**
+   * erase the element at pos.
+   *
+   * throw if pos pointed to a bad element (pos == this->end() || pos points an
+   * element out of this)
+   */
+  void erase(iterator pos) {
+    if (pos.source != this || pos.at >= size()) throw invalid_iterator{};
+    keys.erase(pos.at), values.erase(pos.at);
+  }
+  /**
+   * Returns the number of elements with key
+   *   that compares equivalent to the specified argument,
+   *   which is either 1 or 0
+   *     since this container does not allow duplicates.
+   */
+  size_t count(const Key &key) const { return Find(key) != size(); }
+  /**
+   * Finds an element with key equivalent to key.
+   *   If no such element is found, past-the-end (see end()) iterator is
+   * returned.
+   */
+  iterator find(const Key &key) { return {this, Find(key)}; }
+  const_iterator find(const Key &key) const { return {this, Find(key)}; }
+};
+
+}  // namespace sjtu
+
+#endif
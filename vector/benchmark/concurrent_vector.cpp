@@ -0,0 +1,50 @@
+// push_back throughput of concurrent_vector against sjtu::vector behind a
+// mutex, with 1 to 64 producer threads sharing a fixed number of pushes.
+//   g++ -std=c++17 -O2 -pthread -I../src concurrent_vector.cpp -o cv && ./cv
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.hpp"
+#include "vector.hpp"
+
+// 用 threads 个线程共做 total 次 push，返回每秒百万次。
+template <class Push>
+static double Run(unsigned threads, size_t total, Push push) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; ++t) {
+    pool.emplace_back([&, t] {
+      size_t n = total / threads;
+      for (size_t i = 0; i < n; ++i) push(t * n + i);
+    });
+  }
+  for (auto &th : pool) th.join();
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return total / d.count() / 1e6;
+}
+
+int main() {
+  const size_t total = size_t(1) << 24;
+  std::printf("%8s %18s %18s\n", "threads", "concurrent Mops/s",
+              "mutex Mops/s");
+  for (unsigned threads = 1; threads <= 64; threads *= 2) {
+    double lock_free, locked;
+    {
+      sjtu::concurrent_vector<size_t> v;
+      lock_free = Run(threads, total, [&](size_t x) { v.push_back(x); });
+    }
+    {
+      sjtu::vector<size_t> v;
+      std::mutex m;
+      locked = Run(threads, total, [&](size_t x) {
+        std::lock_guard<std::mutex> guard(m);
+        v.push_back(x);
+      });
+    }
+    std::printf("%8u %18.1f %18.1f\n", threads, lock_free, locked);
+  }
+  return 0;
+}
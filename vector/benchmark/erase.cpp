@@ -0,0 +1,76 @@
+// removing a tenth of the elements of a sjtu::vector: erase_if,
+// erase_indices and swap_erase against calling erase(ind) once per
+// element, for ints (memmove) and std::strings (element-wise moves).
+//   g++ -std=c++17 -O2 -I../src erase.cpp -o erase && ./erase
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "vector.hpp"
+
+template <class F>
+static double Ms(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+static void Check(bool ok) {
+  if (!ok) std::printf("wrong number of elements left\n"), std::exit(1);
+}
+
+template <class T, class Make>
+static void Run(const char *type, size_t n, Make make) {
+  sjtu::vector<T> data;
+  for (size_t i = 0; i < n; ++i) data.push_back(make(i));
+  // 约十分之一的元素被删，按下标升序排列。
+  std::mt19937 rng(7);
+  sjtu::vector<size_t> doomed;
+  sjtu::vector<bool> marked;
+  for (size_t i = 0; i < n; ++i) {
+    bool d = rng() % 10 == 0;
+    marked.push_back(d);
+    if (d) doomed.push_back(i);
+  }
+  const sjtu::vector<bool> &mark = marked;
+  size_t left = n - doomed.size();
+
+  sjtu::vector<T> v = data;
+  double loop = Ms([&] {
+    for (size_t k = doomed.size(); k--;) v.erase(doomed[k]);
+  });
+  Check(v.size() == left);
+  v = data;
+  double indices =
+      Ms([&] { v.erase_indices(doomed.begin(), doomed.end()); });
+  Check(v.size() == left);
+  v = data;
+  size_t at = 0;
+  double by_pred =
+      Ms([&] { v.erase_if([&](const T &) { return mark[at++]; }); });
+  Check(v.size() == left);
+  // 不保序时：从后往前 swap_erase，被换来的元素都在已处理的下标之后。
+  v = data;
+  double swapped = Ms([&] {
+    for (size_t k = doomed.size(); k--;) v.swap_erase(doomed[k]);
+  });
+  Check(v.size() == left);
+
+  std::printf("%-12s n=%-8zu erase loop %9.2f ms  erase_indices %7.2f ms  "
+              "erase_if %7.2f ms  swap_erase %7.2f ms\n",
+              type, n, loop, indices, by_pred, swapped);
+}
+
+int main() {
+  for (size_t n : {size_t(1) << 14, size_t(1) << 17}) {
+    Run<int>("int", n, [](size_t i) { return int(i); });
+    Run<std::string>("std::string", n, [](size_t i) {
+      return "element " + std::to_string(i) + " of a longer string";
+    });
+  }
+  return 0;
+}
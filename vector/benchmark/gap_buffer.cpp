@@ -0,0 +1,74 @@
+// replays a synthetic editing trace against gap_buffer and sjtu::vector:
+// a cursor that mostly moves a few positions between edits (typing,
+// backspace, small cursor moves) and now and then jumps to a random spot,
+// over a document of 2^19 characters. both must end with the same text.
+//   g++ -std=c++17 -O2 -I../src gap_buffer.cpp -o gb && ./gb
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "gap_buffer.hpp"
+#include "vector.hpp"
+
+struct Edit {
+  size_t pos;
+  bool insert;  // 否则删除 pos 处的字符。
+  char c;
+};
+
+// 生成编辑序列；jump 为跳到随机位置的概率（千分比）。
+static sjtu::vector<Edit> Trace(size_t n, size_t edits, unsigned jump) {
+  std::mt19937_64 rng(3);
+  sjtu::vector<Edit> trace;
+  size_t size = n, cur = n / 2;
+  for (size_t i = 0; i < edits; ++i) {
+    if (rng() % 1000 < jump) {
+      cur = rng() % (size + 1);
+    } else if (rng() % 8 == 0) {  // 光标左右挪几格。
+      long d = long(rng() % 17) - 8;
+      cur = d < 0 && size_t(-d) > cur ? 0 : std::min(size, cur + d);
+    }
+    bool insert = rng() % 4 != 0 || !cur;
+    if (insert) {
+      trace.push_back(Edit{cur++, true, char('a' + rng() % 26)});
+      ++size;
+    } else {
+      trace.push_back(Edit{--cur, false, 0});  // 退格。
+      --size;
+    }
+  }
+  return trace;
+}
+
+template <class Seq>
+static double Replay(Seq &s, const sjtu::vector<Edit> &trace) {
+  auto start = std::chrono::steady_clock::now();
+  for (const Edit &e : trace) {
+    if (e.insert)
+      s.insert(e.pos, e.c);
+    else
+      s.erase(e.pos);
+  }
+  std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+int main() {
+  const size_t n = size_t(1) << 19, edits = 200000;
+  for (unsigned jump : {0u, 1u, 10u}) {
+    sjtu::vector<Edit> trace = Trace(n, edits, jump);
+    sjtu::gap_buffer<char> g;
+    sjtu::vector<char> v;
+    for (size_t i = 0; i < n; ++i) g.push_back('.'), v.push_back('.');
+    double tg = Replay(g, trace), tv = Replay(v, trace);
+    if (g.size() != v.size()) return 1;
+    for (size_t i = 0; i < v.size(); ++i)
+      if (g[i] != v[i]) return 1;
+    std::printf("jumps %4.1f%%  %zu edits  gap_buffer %8.2f ms  "
+                "vector %8.2f ms\n",
+                jump / 10.0, edits, tg, tv);
+  }
+  return 0;
+}
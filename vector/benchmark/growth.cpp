@@ -0,0 +1,114 @@
+// cost of the growth of sjtu::vector under push_back, in ns per element,
+// for each way Reallocate moves the old elements:
+//   copy     the move constructor may throw, so the elements are copied
+//            and the originals destroyed only once every copy succeeded;
+//   move     a noexcept move constructor, one element at a time;
+//   memcpy   trivially relocatable elements, one memcpy, or realloc (which
+//            may extend in place or remap) with sjtu::allocator.
+// the elements are std::string (longer than the small-string buffer) and a
+// 24-byte POD struct, wrapped in types that force the copy and move paths.
+// std::string has no memcpy row: libstdc++ keeps a pointer into the object
+// itself for short strings, so it is not trivially relocatable. the same
+// push_back loop into a reserve()d vector is timed alongside; the difference
+// is what growing costs. every number is the best of 5 runs.
+//   g++ -std=c++17 -O2 -I../src growth.cpp -o growth && ./growth
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+
+struct Pod {
+  uint64_t id;
+  double price;
+  uint32_t qty, flags;
+};
+
+// 移动构造没有 noexcept：扩容时只能拷贝。
+template <class T>
+struct ThrowingMove {
+  T value;
+  ThrowingMove(const T &value) : value(value) {}
+  ThrowingMove(const ThrowingMove &) = default;
+  ThrowingMove(ThrowingMove &&other) noexcept(false)
+      : value(std::move(other.value)) {}
+};
+// 移动构造是 noexcept 的，但不是平凡的：扩容时逐个移动。
+template <class T>
+struct NothrowMove {
+  T value;
+  NothrowMove(const T &value) : value(value) {}
+  NothrowMove(const NothrowMove &) = default;
+  NothrowMove(NothrowMove &&other) noexcept : value(std::move(other.value)) {}
+};
+
+static_assert(!std::is_nothrow_move_constructible<ThrowingMove<Pod>>::value &&
+                  !std::is_nothrow_move_constructible<
+                      ThrowingMove<std::string>>::value,
+              "ThrowingMove must take the copy path");
+static_assert(!sjtu::is_trivially_relocatable<NothrowMove<Pod>>::value &&
+                  !sjtu::is_trivially_relocatable<std::string>::value,
+              "NothrowMove and std::string must take the move path");
+static_assert(sjtu::is_trivially_relocatable<Pod>::value,
+              "Pod must take the memcpy path");
+
+template <class F>
+static double Ns(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::nano> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// 把 src 逐个 push_back 进一个新的 V（reserve 为真时先预留空间），取 5 次
+// 中最快的一次。元素事先构造好，计时的只是 push_back 本身。
+template <class V, class T>
+static double Fill(const sjtu::vector<T> &src, bool reserve) {
+  double best = 0;
+  for (int round = 0; round < 5; ++round) {
+    V v;
+    if (reserve) v.reserve(src.size());
+    double t = Ns([&] {
+      for (size_t i = 0; i < src.size(); ++i) v.push_back(src[i]);
+    });
+    if (!round || t < best) best = t;
+  }
+  return best;
+}
+
+template <class V, class T>
+static void Run(const char *type, const char *path,
+                const sjtu::vector<T> &src) {
+  size_t n = src.size();
+  double grow = Fill<V>(src, false), reserved = Fill<V>(src, true);
+  std::printf("%-12s %-22s %8zu %9.2f %9.2f %9.2f\n", type, path, n,
+              grow / n, reserved / n, (grow - reserved) / n);
+}
+
+int main() {
+  std::printf("%-12s %-22s %8s %9s %9s %9s\n", "element", "path", "n",
+              "grow", "reserved", "growth");
+  std::printf("%-12s %-22s %8s %29s\n", "", "", "", "(ns per element)");
+  for (size_t n : {size_t(1) << 16, size_t(1) << 22}) {
+    sjtu::vector<Pod> pods;
+    for (size_t i = 0; i < n; ++i)
+      pods.push_back(Pod{i, i * 0.5, uint32_t(i % 97), 0});
+    Run<sjtu::vector<ThrowingMove<Pod>>>("Pod", "copy", pods);
+    Run<sjtu::vector<NothrowMove<Pod>>>("Pod", "move", pods);
+    Run<sjtu::vector<Pod, std::allocator<Pod>>>("Pod", "memcpy", pods);
+    Run<sjtu::vector<Pod>>("Pod", "memcpy (realloc)", pods);
+
+    sjtu::vector<std::string> strings;
+    for (size_t i = 0; i < n / 4; ++i)
+      strings.push_back("element " + std::to_string(i) + " of the vector");
+    Run<sjtu::vector<ThrowingMove<std::string>>>("std::string", "copy",
+                                                 strings);
+    Run<sjtu::vector<std::string>>("std::string", "move", strings);
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+// random reads over a huge_page_vector<uint64_t> against a plain
+// sjtu::vector<uint64_t> of the same size (4 GiB by default, or the number
+// of GiB given as the first argument), where most reads miss the TLB. two
+// patterns: independent reads at random indices (throughput), and a chain
+// where each index depends on the value read before it (latency). also
+// prints how the kernel backed the huge_page_vector buffer: an explicit
+// MAP_HUGETLB mapping, or the fallback of a normal mapping marked
+// MADV_HUGEPAGE and how much of it transparent huge pages cover.
+// the vectors are built one after the other, so only one is resident.
+//   g++ -std=c++17 -O2 -I../src huge_page.cpp -o hp && ./hp [GiB]
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "aligned_allocator.hpp"
+#include "vector.hpp"
+
+const size_t reads = size_t(1) << 25;
+
+// 把 64 位哈希值映射到 [0, n)，避免取模的除法。
+static size_t Reduce(uint64_t h, size_t n) {
+  return size_t((unsigned __int128)h * n >> 64);
+}
+static uint64_t Mix(uint64_t x) {
+  x ^= x >> 33, x *= 0xff51afd7ed558ccdULL;
+  return x ^ (x >> 33);
+}
+
+// 在 /proc/self/smaps 中找到包含 p 的映射，报告它由哪种页面支撑。
+static void Backing(const void *p) {
+  FILE *f = std::fopen("/proc/self/smaps", "r");
+  if (!f) {
+    std::printf("backing: /proc/self/smaps unavailable\n");
+    return;
+  }
+  char line[512];
+  bool inside = false;
+  unsigned long page_kb = 0, thp_kb = 0, size_kb = 0;
+  bool hugetlb = false, advised = false;
+  while (std::fgets(line, sizeof(line), f)) {
+    unsigned long lo, hi;
+    if (std::sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {  // 映射的首行。
+      if (inside) break;  // 已读完目标映射。
+      inside = lo <= (uintptr_t)p && (uintptr_t)p < hi;
+      continue;
+    }
+    if (!inside) continue;
+    std::sscanf(line, "Size: %lu kB", &size_kb);
+    std::sscanf(line, "KernelPageSize: %lu kB", &page_kb);
+    std::sscanf(line, "AnonHugePages: %lu kB", &thp_kb);
+    if (!std::strncmp(line, "VmFlags:", 8)) {
+      hugetlb = std::strstr(line, " ht") != nullptr;
+      advised = std::strstr(line, " hg") != nullptr;
+    }
+  }
+  std::fclose(f);
+  if (hugetlb)
+    std::printf("backing: MAP_HUGETLB, %lu kB pages\n", page_kb);
+  else
+    std::printf("backing: fallback mapping%s, transparent huge pages cover "
+                "%lu of %lu MiB\n",
+                advised ? " with MADV_HUGEPAGE" : "", thp_kb >> 10,
+                size_kb >> 10);
+}
+
+template <class V>
+static void Run(const char *name, size_t n, bool backing) {
+  V v;
+  v.resize(n);
+  for (size_t i = 0; i < n; ++i) v[i] = Mix(i);
+  if (backing) Backing(v.data());
+  const uint64_t *a = v.data();
+
+  using clock = std::chrono::steady_clock;
+  uint64_t sum = 0;
+  auto start = clock::now();
+  for (size_t i = 0; i < reads; ++i) sum += a[Reduce(Mix(i + n), n)];
+  std::chrono::duration<double, std::nano> indep = clock::now() - start;
+  size_t at = 0;
+  start = clock::now();
+  for (size_t i = 0; i < reads; ++i) at = Reduce(Mix(a[at] + i), n);
+  std::chrono::duration<double, std::nano> chain = clock::now() - start;
+  std::printf("%-16s independent %6.2f ns/read  dependent %7.2f ns/read  "
+              "(%llu)\n",
+              name, indep.count() / reads, chain.count() / reads,
+              (unsigned long long)(sum + at));
+}
+
+int main(int argc, char **argv) {
+  double gib = argc > 1 ? std::atof(argv[1]) : 4;
+  if (!(gib > 0)) {
+    std::printf("usage: %s [GiB]\n", argv[0]);
+    return 1;
+  }
+  size_t n = size_t(gib * (size_t(1) << 30)) / sizeof(uint64_t);
+  std::printf("%zu elements (%.2f GiB), %zu random reads each\n", n, gib,
+              reads);
+  Run<sjtu::vector<uint64_t>>("vector", n, false);
+  Run<sjtu::huge_page_vector<uint64_t>>("huge_page_vector", n, true);
+  return 0;
+}
@@ -0,0 +1,78 @@
+// cold start of a file of 2^24 fixed-size records: opening it as a
+// read-only mapped_vector (alone, and followed by one pass over the
+// records) against re-reading it and pushing every record into a
+// sjtu::vector, as done before mapped_vector existed. the file is
+// created in the current directory and removed at the end; the page cache
+// stays warm, so the numbers measure copying, not the disk.
+//   g++ -std=c++17 -O2 -I../src mapped_vector.cpp -o mv && ./mv
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+#include "mapped_vector.hpp"
+#include "vector.hpp"
+
+struct Record {
+  uint64_t id;
+  double price;
+  uint32_t qty, flags;
+};
+
+static const char *path = "mapped_vector.bench";
+
+template <class F>
+static double Ms(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+static uint64_t Sum(const Record *p, size_t n) {
+  uint64_t s = 0;
+  for (size_t i = 0; i < n; ++i) s += p[i].id + p[i].qty;
+  return s;
+}
+
+int main() {
+  const size_t n = size_t(1) << 24;
+  uint64_t expect = 0;
+  double build = Ms([&] {
+    sjtu::mapped_vector<Record> out(path);
+    out.clear();
+    for (size_t i = 0; i < n; ++i) {
+      out.push_back(Record{i, i * 0.5, uint32_t(i % 97), 0});
+      expect += i + i % 97;
+    }
+  });
+  std::printf("%zu records (%zu MiB); written through push_back in %.0f ms\n",
+              n, n * sizeof(Record) >> 20, build);
+
+  uint64_t sum = 0;
+  double map_open = Ms([&] {
+    sjtu::mapped_vector<Record> v(path, sjtu::mapped_vector<Record>::read_only);
+    sum = v.size();
+  });
+  double map_scan = Ms([&] {
+    sjtu::mapped_vector<Record> v(path, sjtu::mapped_vector<Record>::read_only);
+    sum = Sum(v.data(), v.size());
+  });
+  if (sum != expect) return 1;
+
+  double read_open = Ms([&] {
+    std::ifstream is(path, std::ios::binary);
+    sjtu::vector<Record> v;
+    for (Record r; is.read((char *)&r, sizeof(r));) v.push_back(r);
+    sum = Sum(v.data(), v.size());
+  });
+  if (sum != expect) return 1;
+
+  std::printf("%-32s %8.2f ms\n", "mapped_vector open", map_open);
+  std::printf("%-32s %8.2f ms\n", "mapped_vector open + scan", map_scan);
+  std::printf("%-32s %8.2f ms\n", "read + push_back + scan", read_open);
+  std::remove(path);
+  return 0;
+}
@@ -0,0 +1,104 @@
+// scaling of the parallel algorithms: each one runs on 2^24 elements of a
+// sjtu::vector with 1, 2, 4, ... up to hardware_concurrency() threads
+// (a pool of threads - 1 workers plus the caller), reported as speedup over
+// the sequential std algorithm.
+//   g++ -std=c++17 -O2 -pthread -I../src parallel_algorithm.cpp -o pa && ./pa
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "parallel_algorithm.hpp"
+
+using Data = sjtu::vector<uint64_t>;
+
+template <class F>
+static double Seconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// 算法在一份新的 data 副本上运行，复制不计入时间。
+template <class F>
+static double Time(const Data &data, F f) {
+  Data v = data;
+  return Seconds([&] { f(v); });
+}
+
+static uint64_t sink;
+
+int main() {
+  const size_t n = size_t(1) << 24;
+  Data data, out;
+  std::mt19937_64 rng(12);
+  for (size_t i = 0; i < n; ++i) data.push_back(rng());
+  out.resize(n);
+
+  auto odd = [](uint64_t x) { return x & 1; };
+  // 每个元素做一点计算，使 transform 不只受内存带宽限制。
+  auto work = [](uint64_t x) {
+    for (int i = 0; i < 8; ++i) x = x * 6364136223846793005ULL + 1;
+    return x;
+  };
+  double seq[5] = {
+      Time(data, [](Data &v) { std::sort(v.begin(), v.end()); }),
+      Time(data,
+           [](Data &v) { sink += std::accumulate(v.begin(), v.end(), 0ULL); }),
+      Time(data,
+           [&](Data &v) {
+             std::partial_sum(v.begin(), v.end(), out.begin());
+           }),
+      Time(data,
+           [&](Data &v) {
+             std::transform(v.begin(), v.end(), out.begin(), work);
+           }),
+      Time(data, [&](Data &v) { std::partition(v.begin(), v.end(), odd); }),
+  };
+  std::printf("sequential ms: sort %.0f  reduce %.1f  scan %.1f  "
+              "transform %.1f  partition %.1f\n",
+              seq[0] * 1e3, seq[1] * 1e3, seq[2] * 1e3, seq[3] * 1e3,
+              seq[4] * 1e3);
+  std::printf("%8s %9s %9s %9s %9s %9s   (speedup)\n", "threads", "sort",
+              "reduce", "scan", "transform", "partition");
+
+  size_t most = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t threads = 1;; threads = std::min(threads * 2, most)) {
+    sjtu::thread_pool pool(threads - 1);
+    double t[5] = {
+        Time(data,
+             [&](Data &v) {
+               sjtu::parallel::sort(v.begin(), v.end(), std::less<>(), pool);
+             }),
+        Time(data,
+             [&](Data &v) {
+               sink += sjtu::parallel::reduce(v.begin(), v.end(), 0ULL,
+                                              std::plus<>(), pool);
+             }),
+        Time(data,
+             [&](Data &v) {
+               sjtu::parallel::inclusive_scan(v.begin(), v.end(), out.begin(),
+                                              std::plus<>(), pool);
+             }),
+        Time(data,
+             [&](Data &v) {
+               sjtu::parallel::transform(v.begin(), v.end(), out.begin(), work,
+                                         pool);
+             }),
+        Time(data,
+             [&](Data &v) {
+               sjtu::parallel::partition(v.begin(), v.end(), odd, pool);
+             }),
+    };
+    std::printf("%8zu", threads);
+    for (int i = 0; i < 5; ++i) std::printf(" %9.2f", seq[i] / t[i]);
+    std::printf("\n");
+    if (threads == most) break;
+  }
+  std::printf("checksum %llu\n", (unsigned long long)sink);
+  return 0;
+}
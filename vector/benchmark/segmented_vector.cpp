@@ -0,0 +1,78 @@
+// segmented_vector against sjtu::vector while pushing 2^26 ints: peak
+// resident memory and the latency of single push_back calls (tail
+// percentiles and worst case, where vector pays for moving the whole
+// buffer on growth). every run is a child process of its own so that its
+// peak RSS is measured alone; the latency runs are separate because the
+// timings take memory too. vector is measured with sjtu::allocator, which
+// grows through realloc, and with std::allocator, which must copy.
+//   g++ -std=c++17 -O2 -I../src segmented_vector.cpp -o sv && ./sv
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "segmented_vector.hpp"
+#include "vector.hpp"
+
+const size_t n = size_t(1) << 26;
+
+template <class V>
+static void Fill() {
+  V v;
+  for (size_t i = 0; i < n; ++i) v.push_back(int(i));
+  if (v[n - 1] != int(n - 1)) std::exit(1);
+}
+// 逐次计时 push_back，输出延迟分位数（纳秒）。
+template <class V>
+static void Time(const char *name) {
+  using clock = std::chrono::steady_clock;
+  sjtu::vector<unsigned> ns;  // 先把计时结果的空间备好，免得干扰测量。
+  ns.resize(n);
+  V v;
+  auto begin = clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    auto start = clock::now();
+    v.push_back(int(i));
+    ns[i] = std::chrono::nanoseconds(clock::now() - start).count();
+  }
+  double total = std::chrono::duration<double>(clock::now() - begin).count();
+  if (v[n - 1] != int(n - 1)) std::exit(1);
+  std::sort(ns.begin(), ns.end());
+  std::printf("%-18s total %6.0f ms  p50 %5u  p99.9 %6u  p99.99 %8u  "
+              "max %10u ns\n",
+              name, total * 1e3, ns[n / 2], ns[n - n / 1000],
+              ns[n - n / 10000], ns[n - 1]);
+}
+
+// 在子进程中运行 f，返回其峰值 RSS（MiB）。
+template <class F>
+static long Child(F f) {
+  std::fflush(stdout);
+  pid_t pid = fork();
+  if (!pid) f(), std::fflush(stdout), std::_Exit(0);
+  int status;
+  struct rusage ru;
+  if (wait4(pid, &status, 0, &ru) < 0 || status) std::exit(1);
+  return ru.ru_maxrss / 1024;
+}
+
+template <class V>
+static void Measure(const char *name) {
+  long rss = Child(Fill<V>);
+  std::printf("%-18s peak RSS %5ld MiB\n", name, rss);
+  Child([name] { Time<V>(name); });
+}
+
+int main() {
+  std::printf("payload %zu MiB\n", n * sizeof(int) >> 20);
+  Measure<sjtu::vector<int>>("vector");
+  Measure<sjtu::vector<int, std::allocator<int>>>("vector (std alloc)");
+  Measure<sjtu::segmented_vector<int>>("segmented_vector");
+  Measure<sjtu::segmented_vector<int, 65536>>("segmented<65536>");
+  return 0;
+}
@@ -0,0 +1,109 @@
+// throughput of the simd:: kernels (find, count, min, max, sum) against
+// the scalar loops over operator[] they replace, for int32_t, float and
+// double, on arrays of 16 KiB (L1), 1 MiB (L2/L3) and 128 MiB (memory).
+// find looks for a value that is absent, so every algorithm reads the whole
+// array. each cell is "scalar / simd" in GB/s.
+//   g++ -std=c++17 -O2 -I../src simd_algorithm.cpp -o simd && ./simd
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <type_traits>
+
+#include "simd_algorithm.hpp"
+
+namespace simd = sjtu::simd;
+
+// 每次测量共读入约 1 GiB，小数组就多重复几遍。
+const size_t volume = size_t(1) << 30;
+
+static double sink;
+
+// 重复 f 直到读完 volume 字节，返回 GB/s.
+template <class F>
+static double Rate(size_t bytes, F f) {
+  size_t reps = volume / bytes;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < reps; ++i) sink += double(f());
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return double(bytes) * reps / d.count() / 1e9;
+}
+
+static void Check(bool ok, const char *what) {
+  if (!ok) {
+    std::printf("%s: simd and scalar results differ\n", what);
+    std::exit(1);
+  }
+}
+
+template <class T>
+static void Run(const char *type, size_t bytes) {
+  const size_t n = bytes / sizeof(T);
+  sjtu::vector<T> v;
+  std::mt19937 rng(11);
+  for (size_t i = 0; i < n; ++i) v.push_back(T(rng() % 1000));
+  const sjtu::vector<T> &c = v;
+  const T absent = T(-1), present = T(500);
+
+  auto find = [&] {
+    size_t i = 0;
+    while (i < n && c[i] != absent) ++i;
+    return i;
+  };
+  auto count = [&] {
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) k += c[i] == present;
+    return k;
+  };
+  auto min = [&] {
+    T m = c[0];
+    for (size_t i = 1; i < n; ++i)
+      if (c[i] < m) m = c[i];
+    return m;
+  };
+  auto max = [&] {
+    T m = c[0];
+    for (size_t i = 1; i < n; ++i)
+      if (c[i] > m) m = c[i];
+    return m;
+  };
+  auto sum = [&] {
+    simd::sum_type<T> s = 0;
+    for (size_t i = 0; i < n; ++i) s += c[i];
+    return s;
+  };
+  Check(simd::find(v, absent) == find(), "find");
+  Check(simd::count(v, present) == count(), "count");
+  Check(simd::min(v) == min() && simd::max(v) == max(), "min/max");
+  // 浮点数的求和顺序不同，结果只在整数时逐位相等。
+  if (std::is_integral<T>::value) Check(simd::sum(v) == sum(), "sum");
+
+  double r[5][2] = {
+      {Rate(bytes, find), Rate(bytes, [&] { return simd::find(v, absent); })},
+      {Rate(bytes, count),
+       Rate(bytes, [&] { return simd::count(v, present); })},
+      {Rate(bytes, min), Rate(bytes, [&] { return simd::min(v); })},
+      {Rate(bytes, max), Rate(bytes, [&] { return simd::max(v); })},
+      {Rate(bytes, sum), Rate(bytes, [&] { return simd::sum(v); })},
+  };
+  std::printf("%-8s %4zu %s", type,
+              bytes >= size_t(1) << 20 ? bytes >> 20 : bytes >> 10,
+              bytes >= size_t(1) << 20 ? "MiB" : "KiB");
+  for (auto &cell : r) std::printf("  %5.1f / %5.1f", cell[0], cell[1]);
+  std::printf("\n");
+}
+
+int main() {
+  static const char *isa[] = {"scalar", "SSE2", "AVX2"};
+  std::printf("kernels: %s\n", isa[simd::level()]);
+  std::printf("%-17s  %13s  %13s  %13s  %13s  %13s\n", "", "find", "count",
+              "min", "max", "sum");
+  for (size_t bytes : {size_t(16) << 10, size_t(1) << 20, size_t(128) << 20}) {
+    Run<int32_t>("int32_t", bytes);
+    Run<float>("float", bytes);
+    Run<double>("double", bytes);
+  }
+  std::printf("checksum %g\n", sink);
+  return 0;
+}
@@ -0,0 +1,76 @@
+// save/load throughput of vector_io against writing and reading the same
+// elements one at a time, through a file; also times opening the file as a
+// mapped_view. the file is created in the current directory and removed.
+//   g++ -std=c++17 -O2 -I../src vector_io.cpp -o vector_io && ./vector_io
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "vector_io.hpp"
+
+static const char *path = "vector_io.bench";
+
+template <class F>
+static double Seconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+static void Report(const char *what, size_t bytes, double s) {
+  std::printf("%-28s %8.1f MB/s\n", what, bytes / s / 1e6);
+}
+
+int main() {
+  const size_t n = size_t(1) << 25;
+  sjtu::vector<uint64_t> v;
+  for (size_t i = 0; i < n; ++i) v.push_back(i * 2654435761u);
+  size_t bytes = n * sizeof(uint64_t);
+
+  Report("save (one block)", bytes, Seconds([&] {
+           std::ofstream os(path, std::ios::binary);
+           sjtu::io::save(os, v);
+         }));
+  sjtu::vector<uint64_t> w;
+  Report("load (one block)", bytes, Seconds([&] {
+           std::ifstream is(path, std::ios::binary);
+           sjtu::io::load(is, w);
+         }));
+  if (w.size() != n || w[n - 1] != v[n - 1]) return 1;
+  uint64_t sum = 0;
+  Report("mapped_view open + scan", bytes, Seconds([&] {
+           sjtu::io::mapped_view<uint64_t> m(path);
+           for (uint64_t x : m) sum += x;
+         }));
+
+  // 对照：逐个元素读写同样的数据。
+  Report("save (per element)", bytes, Seconds([&] {
+           std::ofstream os(path, std::ios::binary);
+           for (size_t i = 0; i < n; ++i)
+             os.write((const char *)&v[i], sizeof(uint64_t));
+         }));
+  w.clear();
+  Report("load (per element)", bytes, Seconds([&] {
+           std::ifstream is(path, std::ios::binary);
+           for (uint64_t x; is.read((char *)&x, sizeof(x));) w.push_back(x);
+         }));
+
+  sjtu::vector<bool> b;
+  for (size_t i = 0; i < n; ++i) b.push_back(i % 3 == 0);
+  Report("save vector<bool>", n / 8, Seconds([&] {
+           std::ofstream os(path, std::ios::binary);
+           sjtu::io::save(os, b);
+         }));
+  sjtu::vector<bool> c;
+  Report("load vector<bool>", n / 8, Seconds([&] {
+           std::ifstream is(path, std::ios::binary);
+           sjtu::io::load(is, c);
+         }));
+  if (c.count() != b.count()) return 1;
+
+  std::remove(path);
+  std::printf("checksum %llu\n", (unsigned long long)sum);
+  return 0;
+}
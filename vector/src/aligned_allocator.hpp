@@ -0,0 +1,143 @@
+#ifndef SJTU_ALIGNED_ALLOCATOR_HPP
+#define SJTU_ALIGNED_ALLOCATOR_HPP
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * an allocator returning storage aligned to Align bytes (at least
+ * alignof(T)), e.g. 32 or 64 so that the buffer of a vector can be read
+ * with aligned AVX loads and never straddles cache lines at its start.
+ */
+template <typename T, size_t Align = 64>
+class aligned_allocator {
+  static_assert(Align && !(Align & (Align - 1)),
+                "Align must be a power of 2");
+
+ public:
+  using value_type = T;
+  static constexpr size_t alignment = Align > alignof(T) ? Align : alignof(T);
+  template <typename U>
+  struct rebind {
+    using other = aligned_allocator<U, Align>;
+  };
+
+  aligned_allocator() = default;
+  template <typename U>
+  aligned_allocator(const aligned_allocator<U, Align> &) {}
+
+  T *allocate(size_t n) {
+    void *p = ::operator new(n * sizeof(T), std::align_val_t(alignment),
+                             std::nothrow);
+    if (!p) throw runtime_error();
+    return (T *)p;
+  }
+  void deallocate(T *p, size_t) {
+    ::operator delete((void *)p, std::align_val_t(alignment));
+  }
+
+  template <typename U>
+  bool operator==(const aligned_allocator<U, Align> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const aligned_allocator<U, Align> &) const {
+    return false;
+  }
+};
+
+/**
+ * an allocator backing large buffers with huge pages, so that random access
+ * over a big vector costs far fewer TLB misses.
+ * requests of at least Threshold bytes are mapped directly with mmap,
+ * rounded up to whole 2 MiB pages: an explicit hugetlb mapping is tried
+ * first, and if none is available (no pages reserved in
+ * /proc/sys/vm/nr_hugepages) the memory is mapped normally, aligned to 2 MiB
+ * and marked MADV_HUGEPAGE for transparent huge pages.
+ * smaller requests are served like aligned_allocator<T, Align>.
+ */
+template <typename T, size_t Align = 64, size_t Threshold = (size_t(1) << 21)>
+class huge_page_allocator {
+  static constexpr size_t huge_page = size_t(1) << 21;
+
+  aligned_allocator<T, Align> small;
+
+  static size_t Round(size_t bytes) {
+    return (bytes + huge_page - 1) & ~(huge_page - 1);
+  }
+  static void *Map(size_t len) {
+    void *p;
+#ifdef MAP_HUGETLB
+    p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) return p;
+#endif
+    // 多映射一个大页，截掉首尾，使起点按 2 MiB 对齐。
+    p = mmap(nullptr, len + huge_page, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    char *raw = (char *)p;
+    char *aligned =
+        (char *)(((uintptr_t)raw + huge_page - 1) & ~(huge_page - 1));
+    if (aligned != raw) munmap(raw, aligned - raw);
+    munmap(aligned + len, raw + huge_page - aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, len, MADV_HUGEPAGE);  // 失败时仍是普通页，不影响使用。
+#endif
+    return aligned;
+  }
+
+ public:
+  using value_type = T;
+  // small 不带状态，任意两个实例都能释放彼此申请的内存；成员使默认的判断
+  // （is_empty）不成立，所以显式声明。
+  using is_always_equal = std::true_type;
+  static constexpr size_t threshold = Threshold;
+  template <typename U>
+  struct rebind {
+    using other = huge_page_allocator<U, Align, Threshold>;
+  };
+
+  huge_page_allocator() = default;
+  template <typename U>
+  huge_page_allocator(const huge_page_allocator<U, Align, Threshold> &) {}
+
+  T *allocate(size_t n) {
+    size_t bytes = n * sizeof(T);
+    if (bytes < Threshold) return small.allocate(n);
+    void *p = Map(Round(bytes));
+    if (!p) throw runtime_error();
+    return (T *)p;
+  }
+  void deallocate(T *p, size_t n) {
+    size_t bytes = n * sizeof(T);
+    if (bytes < Threshold) return small.deallocate(p, n);
+    munmap((void *)p, Round(bytes));
+  }
+
+  template <typename U>
+  bool operator==(const huge_page_allocator<U, Align, Threshold> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const huge_page_allocator<U, Align, Threshold> &) const {
+    return false;
+  }
+};
+
+template <typename T, size_t Align = 64, class Growth = double_growth>
+using aligned_vector = vector<T, aligned_allocator<T, Align>, Growth>;
+template <typename T, class Growth = double_growth>
+using huge_page_vector = vector<T, huge_page_allocator<T>, Growth>;
+
+}  // namespace sjtu
+
+#endif
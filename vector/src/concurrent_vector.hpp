@@ -0,0 +1,136 @@
+#ifndef SJTU_CONCURRENT_VECTOR_HPP
+#define SJTU_CONCURRENT_VECTOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * an append-only vector that many threads may push into and read from at
+ * the same time without locks.
+ * storage is a fixed table of segments of FirstSize, 2 * FirstSize,
+ * 4 * FirstSize, ... elements, so growing never moves an element. a
+ * thread that finds its segment missing allocates it and installs it with
+ * compare-and-swap (a thread losing the race frees its copy), so no thread
+ * ever waits for another. to keep such races rare, the thread that claims
+ * the middle index of segment k installs segment k + 1 ahead of time.
+ *
+ * push_back claims an index with one atomic increment, constructs the
+ * element in its slot and then publishes it; the returned index stays valid
+ * for the whole life of the container. size() counts claimed indices, so
+ * an element below size() may still be under construction: at() throws
+ * index_out_of_bound for any index that is not published yet.
+ * destruction is not thread safe.
+ */
+template <typename T, size_t FirstSize = 64>
+class concurrent_vector {
+  static_assert(FirstSize && !(FirstSize & (FirstSize - 1)),
+                "FirstSize must be a power of 2");
+  static constexpr size_t max_segments = 64;
+
+  struct Slot {
+    alignas(T) unsigned char buf[sizeof(T)];
+    std::atomic<bool> ready{false};
+
+    T *get() { return (T *)buf; }
+    const T *get() const { return (const T *)buf; }
+  };
+
+  std::atomic<Slot *> segments[max_segments]{};
+  std::atomic<size_t> cur_size{0};
+
+  // 第 k 段从 FirstSize * (2^k - 1) 开始，长 FirstSize * 2^k.
+  static size_t SegmentOf(size_t pos) {
+    return 63 - __builtin_clzll(pos / FirstSize + 1);
+  }
+  static size_t SegmentBegin(size_t k) {
+    return FirstSize * ((size_t(1) << k) - 1);
+  }
+  static size_t SegmentSize(size_t k) { return FirstSize << k; }
+
+  Slot *GetSegment(size_t k) {
+    Slot *seg = segments[k].load(std::memory_order_acquire);
+    if (seg) return seg;
+    Slot *fresh = new Slot[SegmentSize(k)];
+    if (segments[k].compare_exchange_strong(seg, fresh,
+                                            std::memory_order_acq_rel))
+      return fresh;
+    delete[] fresh;  // 别的线程已装好了这一段。
+    return seg;
+  }
+  const Slot *Find(size_t pos) const {
+    if (pos >= cur_size.load(std::memory_order_acquire)) return nullptr;
+    size_t k = SegmentOf(pos);
+    const Slot *seg = segments[k].load(std::memory_order_acquire);
+    if (!seg) return nullptr;
+    const Slot *slot = seg + (pos - SegmentBegin(k));
+    return slot->ready.load(std::memory_order_acquire) ? slot : nullptr;
+  }
+
+ public:
+  concurrent_vector() = default;
+  concurrent_vector(const concurrent_vector &) = delete;
+  concurrent_vector &operator=(const concurrent_vector &) = delete;
+  ~concurrent_vector() {
+    size_t n = cur_size.load();
+    for (size_t k = 0; k < max_segments; ++k) {
+      Slot *seg = segments[k].load();
+      if (!seg) continue;
+      for (size_t i = 0; i < SegmentSize(k) && SegmentBegin(k) + i < n; ++i)
+        if (seg[i].ready.load()) seg[i].get()->~T();
+      delete[] seg;
+    }
+  }
+
+  /**
+   * appends an element and returns its index. thread safe.
+   * if the constructor of T throws, the index is lost: it stays
+   * unpublished and the exception is rethrown.
+   */
+  template <class... Args>
+  size_t emplace_back(Args &&...args) {
+    size_t pos = cur_size.fetch_add(1, std::memory_order_relaxed);
+    size_t k = SegmentOf(pos), off = pos - SegmentBegin(k);
+    Slot *slot = GetSegment(k) + off;
+    // 这一段用到一半时提前装好下一段，后来的线程就不必等待分配。
+    if (off == SegmentSize(k) / 2 && k + 1 < max_segments) GetSegment(k + 1);
+    new (slot->get()) T(std::forward<Args>(args)...);
+    slot->ready.store(true, std::memory_order_release);
+    return pos;
+  }
+  size_t push_back(const T &value) { return emplace_back(value); }
+  size_t push_back(T &&value) { return emplace_back(std::move(value)); }
+
+  /**
+   * the element at pos. thread safe.
+   * throw index_out_of_bound if pos has not been published yet.
+   */
+  const T &at(const size_t &pos) const {
+    const Slot *slot = Find(pos);
+    if (!slot) throw index_out_of_bound();
+    return *slot->get();
+  }
+  T &at(const size_t &pos) {
+    return const_cast<T &>(((const concurrent_vector *)this)->at(pos));
+  }
+  const T &operator[](const size_t &pos) const { return at(pos); }
+  T &operator[](const size_t &pos) { return at(pos); }
+  /**
+   * whether the element at pos is constructed and visible.
+   */
+  bool is_published(const size_t &pos) const { return Find(pos); }
+
+  /**
+   * the number of indices handed out so far.
+   */
+  size_t size() const { return cur_size.load(std::memory_order_acquire); }
+  bool empty() const { return !size(); }
+};
+
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef SJTU_COW_VECTOR_HPP
+#define SJTU_COW_VECTOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a copy-on-write vector: copies share one reference-counted sjtu::vector
+ * (the count is atomic, so copies may live in different threads), and
+ * copying or snapshot() is O(1) whatever the size.
+ * every non-const member first makes the buffer private (a deep copy if it
+ * is shared), so a copy never observes later changes of the original.
+ *
+ * references, pointers and iterators obtained through non-const members
+ * must not be used to modify the vector after it has been copied: they
+ * still point into the buffer now shared with the copy.
+ */
+template <typename T, class Allocator = allocator<T>,
+          class Growth = double_growth>
+class cow_vector {
+ public:
+  using value_type = T;
+  using base_type = vector<T, Allocator, Growth>;
+  using iterator = typename base_type::iterator;
+  using const_iterator = typename base_type::const_iterator;
+  // 一般是 T & 与 const T &；vector<bool> 按位存储，是代理对象与 bool.
+  using reference = decltype(std::declval<base_type &>()[0]);
+  using const_reference = decltype(std::declval<const base_type &>()[0]);
+
+ private:
+  struct Rep {
+    std::atomic<size_t> refs{1};
+    base_type data;
+
+    Rep() = default;
+    explicit Rep(const base_type &data) : data(data) {}
+    explicit Rep(base_type &&data) : data(std::move(data)) {}
+  };
+  Rep *rep{nullptr};  // 空指针表示空的 vector，还没有任何缓冲区。
+
+  static const base_type &Empty() {
+    static const base_type empty;
+    return empty;
+  }
+  const base_type &Get() const { return rep ? rep->data : Empty(); }
+  void Release() {
+    if (rep && rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete rep;
+    rep = nullptr;
+  }
+  // 修改前调用：独占缓冲区，必要时复制一份。
+  // 共享时旧缓冲区仍被别的副本持有，传入的引用即使指向其中也依然有效。
+  base_type &Detach() {
+    if (!rep) {
+      rep = new Rep();
+    } else if (rep->refs.load(std::memory_order_acquire) != 1) {
+      Rep *own = new Rep(rep->data);
+      Release();
+      rep = own;
+    }
+    return rep->data;
+  }
+
+ public:
+  cow_vector() = default;
+  explicit cow_vector(const base_type &other) : rep(new Rep(other)) {}
+  explicit cow_vector(base_type &&other) : rep(new Rep(std::move(other))) {}
+  cow_vector(const cow_vector &other) : rep(other.rep) {
+    if (rep) rep->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+  cow_vector(cow_vector &&other) noexcept : rep(other.rep) {
+    other.rep = nullptr;
+  }
+  ~cow_vector() { Release(); }
+
+  cow_vector &operator=(const cow_vector &other) {
+    if (other.rep != rep) {
+      if (other.rep) other.rep->refs.fetch_add(1, std::memory_order_relaxed);
+      Release();
+      rep = other.rep;
+    }
+    return *this;
+  }
+  cow_vector &operator=(cow_vector &&other) noexcept {
+    if (&other != this) {
+      Release();
+      rep = other.rep, other.rep = nullptr;
+    }
+    return *this;
+  }
+
+  /**
+   * an O(1) copy sharing the buffer.
+   */
+  cow_vector snapshot() const { return *this; }
+  /**
+   * the number of cow_vectors sharing the buffer (0 if there is none).
+   */
+  size_t use_count() const {
+    return rep ? rep->refs.load(std::memory_order_acquire) : 0;
+  }
+  /**
+   * read-only access to the underlying vector.
+   */
+  const base_type &get() const { return Get(); }
+
+  reference at(const size_t &pos) {
+    if (pos >= size()) throw index_out_of_bound();
+    return Detach()[pos];
+  }
+  const_reference at(const size_t &pos) const { return Get().at(pos); }
+  reference operator[](const size_t &pos) { return at(pos); }
+  const_reference operator[](const size_t &pos) const { return at(pos); }
+
+  const_reference front() const { return Get().front(); }
+  const_reference back() const { return Get().back(); }
+
+  iterator begin() { return Detach().begin(); }
+  const_iterator begin() const { return Get().begin(); }
+  const_iterator cbegin() const { return Get().cbegin(); }
+  iterator end() { return Detach().end(); }
+  const_iterator end() const { return Get().end(); }
+  const_iterator cend() const { return Get().cend(); }
+  T *data() { return Detach().data(); }
+  const T *data() const { return Get().data(); }
+
+  bool empty() const { return Get().empty(); }
+  size_t size() const { return Get().size(); }
+  size_t capacity() const { return Get().capacity(); }
+  void reserve(const size_t &n) { Detach().reserve(n); }
+  void shrink_to_fit() { Detach().shrink_to_fit(); }
+  void resize(const size_t &n) { Detach().resize(n); }
+  void resize(const size_t &n, const T &value) { Detach().resize(n, value); }
+  /**
+   * drops this reference to the buffer; other copies are not affected.
+   */
+  void clear() { Release(); }
+
+  iterator insert(const size_t &ind, const T &value) {
+    if (ind > size()) throw index_out_of_bound();
+    return Detach().insert(ind, value);
+  }
+  iterator insert(const size_t &ind, T &&value) {
+    if (ind > size()) throw index_out_of_bound();
+    return Detach().insert(ind, std::move(value));
+  }
+  iterator erase(const size_t &ind) {
+    if (ind >= size()) throw index_out_of_bound();
+    return Detach().erase(ind);
+  }
+  void push_back(const T &value) { Detach().push_back(value); }
+  void push_back(T &&value) { Detach().push_back(std::move(value)); }
+  template <class... Args>
+  T &emplace_back(Args &&...args) {
+    return Detach().emplace_back(std::forward<Args>(args)...);
+  }
+  /**
+   * throw container_is_empty if size() == 0
+   */
+  void pop_back() {
+    if (empty()) throw container_is_empty();
+    Detach().pop_back();
+  }
+};
+
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef SJTU_DELTA_VECTOR_HPP
+#define SJTU_DELTA_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "static_vector.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a compressed vector of non-decreasing 64-bit integers (e.g. sorted ids).
+ *
+ * values are grouped in blocks of 128. a full block keeps the differences
+ * between neighbouring values, all packed with the bit width of the
+ * largest one, so dense ids take a few bits each instead of 64; a skip
+ * index holds the first value and the position of every block, so
+ * lower_bound() binary searches the index and decodes a single block.
+ * the last, unfilled block stays uncompressed until it fills up.
+ *
+ * a block is decoded by code generated for its bit width and fully
+ * unrolled, so every shift and mask is a constant, adding up the
+ * differences as it goes. for_each() is the fastest scan; the iterators
+ * decode one block at a time into a buffer they carry, so they are large
+ * and meant for forward scans.
+ */
+class delta_vector {
+ public:
+  static constexpr size_t block = 128;
+
+ private:
+  using word = uint64_t;
+  // 一块 128 个差值，每 1 位宽度恰好占两个词。
+  static constexpr size_t words_per_bit = block / 64;
+
+  struct Block {
+    word first;     // 块内第一个值。
+    size_t offset;  // 压缩数据在 words 中的起点。
+    unsigned width;
+  };
+
+  vector<Block> index;
+  vector<word> words;
+  static_vector<word, block> tail;  // 尚未填满的最后一块，不压缩。
+
+  using Unpacker = void (*)(const word *, word, word *);
+  // 按固定位宽 B 解出 128 个差值并求前缀和，所有移位量都是编译期常量。
+  template <unsigned B>
+  static void Unpack(const word *in, word first, word *out) {
+    word acc = first;
+#pragma GCC unroll 128
+    for (size_t i = 0; i < block; ++i) {
+      if constexpr (B != 0) {
+        constexpr word mask = B == 64 ? ~word(0) : (word(1) << B) - 1;
+        size_t bit = i * B, w = bit / 64, s = bit % 64;
+        word x = in[w] >> s;
+        if (s + B > 64) x |= in[w + 1] << (64 - s);
+        acc += x & mask;
+      }
+      out[i] = acc;
+    }
+  }
+  template <size_t... B>
+  static Unpacker Pick(unsigned width, std::index_sequence<B...>) {
+    static constexpr Unpacker table[] = {&Unpack<B>...};
+    return table[width];
+  }
+
+  // 把第 blk 块解到 out 中，返回其中值的个数。
+  size_t Decode(size_t blk, word *out) const {
+    if (blk == index.size()) {
+      std::copy(tail.begin(), tail.end(), out);
+      return tail.size();
+    }
+    const Block &b = index.data()[blk];
+    Pick(b.width, std::make_index_sequence<65>())(words.data() + b.offset,
+                                                  b.first, out);
+    return block;
+  }
+  // 压缩已满的 tail 并追加为一个新块。
+  void Seal() {
+    word delta[block], max = 0;
+    delta[0] = 0;
+    for (size_t i = 1; i < block; ++i)
+      delta[i] = tail[i] - tail[i - 1], max = std::max(max, delta[i]);
+    unsigned width = max ? 64 - __builtin_clzll(max) : 0;
+    size_t offset = words.size();
+    words.resize(offset + width * words_per_bit);
+    index.push_back(Block{tail[0], offset, width});
+    word *out = words.data() + offset;
+    for (size_t i = 1; width && i < block; ++i) {
+      size_t bit = i * width, w = bit / 64, s = bit % 64;
+      out[w] |= delta[i] << s;
+      if (s + width > 64) out[w + 1] |= delta[i] >> (64 - s);
+    }
+    tail.clear();
+  }
+
+ public:
+  /**
+   * forward iterator over the values; * yields a value, not a reference.
+   */
+  class const_iterator {
+    friend class delta_vector;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = uint64_t;
+    using pointer = void;
+    using reference = uint64_t;
+    using iterator_category = std::input_iterator_tag;
+
+   private:
+    const delta_vector *source{nullptr};
+    size_t at{0};
+    word buf[block];
+
+    const_iterator(const delta_vector *source, size_t at)
+        : source(source), at(at) {
+      if (at < source->size()) source->Decode(at / block, buf);
+    }
+
+   public:
+    const_iterator() = default;
+
+    const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    const_iterator &operator++() {
+      if (++at % block == 0 && at < source->size())
+        source->Decode(at / block, buf);
+      return *this;
+    }
+    uint64_t operator*() const { return buf[at % block]; }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+  };
+  using iterator = const_iterator;
+
+  delta_vector() = default;
+
+  /**
+   * appends value, which must not be less than back().
+   * throw runtime_error if value < back()
+   */
+  void push_back(uint64_t value) {
+    if (!empty() && value < back()) throw runtime_error();
+    tail.push_back(value);
+    if (tail.full()) Seal();
+  }
+
+  /**
+   * throw index_out_of_bound if pos >= size
+   */
+  uint64_t at(const size_t &pos) const {
+    if (pos >= size()) throw index_out_of_bound();
+    if (pos / block == index.size()) return tail[pos % block];
+    word buf[block];
+    Decode(pos / block, buf);
+    return buf[pos % block];
+  }
+  uint64_t operator[](const size_t &pos) const { return at(pos); }
+  /**
+   * throw container_is_empty if size == 0
+   */
+  uint64_t front() const {
+    if (empty()) throw container_is_empty();
+    return index.empty() ? tail[0] : index[0].first;
+  }
+  uint64_t back() const {
+    if (empty()) throw container_is_empty();
+    return tail.empty() ? at(size() - 1) : tail.back();
+  }
+
+  /**
+   * the index of the first value not less than value, or size() if every
+   * value is less.
+   */
+  size_t lower_bound(uint64_t value) const {
+    // 找最后一个首值小于 value 的块，答案在这一块内或紧随其后。
+    size_t l = 0, r = index.size();
+    while (l < r) {
+      size_t mid = (l + r) / 2;
+      if (index[mid].first < value)
+        l = mid + 1;
+      else
+        r = mid;
+    }
+    size_t blk = l;
+    if (blk == index.size() && !tail.empty() && tail[0] < value) {
+      return blk * block +
+             (std::lower_bound(tail.begin(), tail.end(), value) - tail.begin());
+    }
+    if (!blk) return 0;
+    word buf[block];
+    size_t n = Decode(--blk, buf);
+    return blk * block + (std::lower_bound(buf, buf + n, value) - buf);
+  }
+  bool contains(uint64_t value) const {
+    size_t i = lower_bound(value);
+    return i < size() && at(i) == value;
+  }
+
+  /**
+   * calls f(value) for every value in order, a block at a time; cheaper
+   * per value than the iterators.
+   */
+  template <class F>
+  void for_each(F f) const {
+    word buf[block];
+    for (size_t blk = 0; blk <= index.size(); ++blk) {
+      size_t n = Decode(blk, buf);
+      for (size_t i = 0; i < n; ++i) f(buf[i]);
+    }
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator cbegin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+  const_iterator cend() const { return const_iterator(this, size()); }
+
+  bool empty() const { return !size(); }
+  size_t size() const { return index.size() * block + tail.size(); }
+  /**
+   * the number of bytes held by the compressed blocks and the index,
+   * excluding unused capacity.
+   */
+  size_t bytes() const {
+    return words.size() * sizeof(word) + index.size() * sizeof(Block) +
+           sizeof(*this);
+  }
+  void clear() { index.clear(), words.clear(), tail.clear(); }
+  /**
+   * releases the unused capacity of the blocks and the index.
+   */
+  void shrink_to_fit() { index.shrink_to_fit(), words.shrink_to_fit(); }
+};
+
+}  // namespace sjtu
+
+#endif
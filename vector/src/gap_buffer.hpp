@@ -0,0 +1,395 @@
+#ifndef SJTU_GAP_BUFFER_HPP
+#define SJTU_GAP_BUFFER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a sequence with the interface of sjtu::vector, tuned for insertions and
+ * removals clustered around a moving position, as in a text editor.
+ * the elements live in one buffer with a hole (the gap) at the last edit
+ * position: inserting or erasing there is amortized O(1), and moving the
+ * edit position by d elements costs O(d) moves.
+ * positions far from the last edit cost as much as in a vector; random
+ * access is O(1) in all cases.
+ */
+template <typename T, class Allocator = allocator<T>>
+class gap_buffer {
+  using Traits = std::allocator_traits<Allocator>;
+
+  T *array{nullptr};
+  size_t limit{0};
+  size_t gap_begin{0}, gap_end{0};  // [gap_begin, gap_end) 为空位。
+  Allocator alloc;
+
+  size_t Gap() const { return gap_end - gap_begin; }
+  T *Slot(size_t pos) const {
+    return array + (pos < gap_begin ? pos : pos + Gap());
+  }
+  void Destroy(T *p) { Traits::destroy(alloc, p); }
+  // 把 src 处的元素搬到空位 dst 上。
+  void Move(T *dst, T *src) {
+    Traits::construct(alloc, dst, std::move_if_noexcept(*src));
+    Destroy(src);
+  }
+  // 把空位移到逻辑位置 pos。逐个搬动并随之更新空位，中途抛异常时结构仍然完整。
+  void MoveGap(size_t pos) {
+    if (!Gap()) return (void)(gap_begin = gap_end = pos);  // 没有空位可搬。
+    if constexpr (is_trivially_relocatable<T>::value) {
+      if (pos < gap_begin) {
+        size_t n = gap_begin - pos;
+        memmove((void *)(array + gap_end - n), (const void *)(array + pos),
+                n * sizeof(T));
+        gap_begin -= n, gap_end -= n;
+      } else if (pos > gap_begin) {
+        size_t n = pos - gap_begin;
+        memmove((void *)(array + gap_begin), (const void *)(array + gap_end),
+                n * sizeof(T));
+        gap_begin += n, gap_end += n;
+      }
+    } else {
+      for (; gap_begin > pos; --gap_begin, --gap_end)
+        Move(array + gap_end - 1, array + gap_begin - 1);
+      for (; gap_begin < pos; ++gap_begin, ++gap_end)
+        Move(array + gap_begin, array + gap_end);
+    }
+  }
+  // 换到容量为 n 的新缓冲区，空位保持在原来的逻辑位置。
+  void Reallocate(size_t n) {
+    size_t len = size(), tail = limit - gap_end;
+    T *tmp = n ? Traits::allocate(alloc, n) : nullptr;
+    if constexpr (is_trivially_relocatable<T>::value) {
+      if (gap_begin)
+        memcpy((void *)tmp, (const void *)array, gap_begin * sizeof(T));
+      if (tail)
+        memcpy((void *)(tmp + n - tail), (const void *)(array + gap_end),
+               tail * sizeof(T));
+    } else {
+      // 逻辑位置 i 的元素在新缓冲区中的位置。
+      auto To = [&](size_t i) {
+        return tmp + (i < gap_begin ? i : i + n - len);
+      };
+      size_t done = 0;
+      try {
+        for (; done < len; ++done)
+          Traits::construct(alloc, To(done),
+                            std::move_if_noexcept(*Slot(done)));
+      } catch (...) {
+        while (done--) Destroy(To(done));
+        Traits::deallocate(alloc, tmp, n);
+        throw;
+      }
+      for (size_t i = 0; i < len; ++i) Destroy(Slot(i));
+    }
+    if (array) Traits::deallocate(alloc, array, limit);
+    array = tmp, limit = n, gap_end = gap_begin + (n - len);
+  }
+  void Grow() { Reallocate(limit ? limit << 1 : 8); }
+  // 接管 other 的空间，需保证自己当前没有空间。
+  void Steal(gap_buffer &other) {
+    array = other.array, limit = other.limit;
+    gap_begin = other.gap_begin, gap_end = other.gap_end;
+    other.array = nullptr, other.limit = other.gap_begin = other.gap_end = 0;
+  }
+  // 把 other 的元素逐个移动到自己的空间上，需保证自己当前为空。
+  void MoveFrom(gap_buffer &other) {
+    reserve(other.size());
+    for (size_t i = 0; i < other.size(); ++i)
+      push_back(std::move(*other.Slot(i)));
+    other.clear();
+  }
+  // 归还空间，需保证当前为空。
+  void Release() {
+    if (array) Traits::deallocate(alloc, array, limit);
+    array = nullptr, limit = gap_begin = gap_end = 0;
+  }
+
+ public:
+  /**
+   * index based random access iterators; they refer to positions, so an
+   * edit shifts which element an iterator after it refers to, as in
+   * vector.
+   */
+  class const_iterator;
+  class iterator {
+    friend class gap_buffer;
+    friend class const_iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = T *;
+    using reference = T &;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    gap_buffer *source{nullptr};
+
+    iterator(size_t at, gap_buffer *source) : at(at), source(source) {}
+
+   public:
+    iterator() = default;
+
+    iterator operator+(const difference_type &n) const {
+      return iterator(at + n, source);
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
+      return iterator(at - n, source);
+    }
+    // if these two iterators point to different vectors, throw
+    // invaild_iterator.
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    iterator &operator+=(const difference_type &n) { return at += n, *this; }
+    iterator &operator-=(const difference_type &n) { return at -= n, *this; }
+
+    iterator operator++(int) { return iterator(at++, source); }
+    iterator &operator++() { return ++at, *this; }
+    iterator operator--(int) { return iterator(at--, source); }
+    iterator &operator--() { return --at, *this; }
+
+    T &operator*() const { return *source->Slot(at); }
+    T *operator->() const { return source->Slot(at); }
+    T &operator[](const difference_type &n) const { return *(*this + n); }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+  class const_iterator {
+    friend class gap_buffer;
+    friend class iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = const T *;
+    using reference = const T &;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    const gap_buffer *source{nullptr};
+
+    const_iterator(size_t at, const gap_buffer *source)
+        : at(at), source(source) {}
+
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &other)
+        : at(other.at), source(other.source) {}
+
+    const_iterator operator+(const difference_type &n) const {
+      return const_iterator(at + n, source);
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
+      return const_iterator(at - n, source);
+    }
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    const_iterator &operator+=(const difference_type &n) {
+      return at += n, *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      return at -= n, *this;
+    }
+
+    const_iterator operator++(int) { return const_iterator(at++, source); }
+    const_iterator &operator++() { return ++at, *this; }
+    const_iterator operator--(int) { return const_iterator(at--, source); }
+    const_iterator &operator--() { return --at, *this; }
+
+    const T &operator*() const { return *source->Slot(at); }
+    const T *operator->() const { return source->Slot(at); }
+    const T &operator[](const difference_type &n) const {
+      return *(*this + n);
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+
+  gap_buffer() = default;
+  explicit gap_buffer(const Allocator &alloc) : alloc(alloc) {}
+  gap_buffer(const gap_buffer &other)
+      : alloc(Traits::select_on_container_copy_construction(other.alloc)) {
+    reserve(other.size());
+    for (size_t i = 0; i < other.size(); ++i) push_back(*other.Slot(i));
+  }
+  // 分配器相等时直接接管 other 的空间，否则只能逐个移动到自己的空间上。
+  gap_buffer(gap_buffer &&other) noexcept(Traits::is_always_equal::value)
+      : alloc(std::move(other.alloc)) {
+    if (Traits::is_always_equal::value || alloc == other.alloc)
+      Steal(other);
+    else
+      MoveFrom(other);
+  }
+  ~gap_buffer() { clear(), Release(); }
+
+  gap_buffer &operator=(const gap_buffer &other) {
+    if (&other != this) {
+      clear();
+      // 分配器随拷贝传播时，旧空间须由原分配器归还。
+      if constexpr (Traits::propagate_on_container_copy_assignment::value) {
+        if (alloc != other.alloc) Release();
+        alloc = other.alloc;
+      }
+      reserve(other.size());
+      for (size_t i = 0; i < other.size(); ++i) push_back(*other.Slot(i));
+    }
+    return *this;
+  }
+  gap_buffer &operator=(gap_buffer &&other) noexcept(
+      Traits::propagate_on_container_move_assignment::value ||
+      Traits::is_always_equal::value) {
+    if (&other != this) {
+      clear();
+      if constexpr (Traits::propagate_on_container_move_assignment::value) {
+        Release(), alloc = std::move(other.alloc), Steal(other);
+      } else if (Traits::is_always_equal::value || alloc == other.alloc) {
+        Release(), Steal(other);
+      } else {
+        MoveFrom(other);
+      }
+    }
+    return *this;
+  }
+
+  T &at(const size_t &pos) {
+    if (pos >= size()) throw index_out_of_bound();
+    return *Slot(pos);
+  }
+  const T &at(const size_t &pos) const {
+    if (pos >= size()) throw index_out_of_bound();
+    return *Slot(pos);
+  }
+  T &operator[](const size_t &pos) { return at(pos); }
+  const T &operator[](const size_t &pos) const { return at(pos); }
+
+  const T &front() const {
+    if (empty()) throw container_is_empty();
+    return *Slot(0);
+  }
+  const T &back() const {
+    if (empty()) throw container_is_empty();
+    return *Slot(size() - 1);
+  }
+
+  iterator begin() { return iterator(0, this); }
+  const_iterator begin() const { return const_iterator(0, this); }
+  const_iterator cbegin() const { return const_iterator(0, this); }
+  iterator end() { return iterator(size(), this); }
+  const_iterator end() const { return const_iterator(size(), this); }
+  const_iterator cend() const { return const_iterator(size(), this); }
+
+  bool empty() const { return !size(); }
+  size_t size() const { return limit - Gap(); }
+  size_t capacity() const { return limit; }
+  void reserve(const size_t &n) {
+    if (n > limit) Reallocate(n);
+  }
+  void shrink_to_fit() {
+    if (Gap()) Reallocate(size());
+  }
+  void clear() {
+    for (size_t i = 0, n = size(); i < n; ++i) Destroy(Slot(i));
+    gap_begin = 0, gap_end = limit;
+  }
+
+  /**
+   * constructs an element in place from args at index ind, moving the gap
+   * there first.
+   * throw index_out_of_bound if ind > size
+   */
+  template <class... Args>
+  iterator emplace(const size_t &ind, Args &&...args) {
+    if (ind > size()) throw index_out_of_bound();
+    if (ind != gap_begin || !Gap()) {
+      // 移动空位或扩容都会搬动元素，args 可能引用其中之一，先构造出来。
+      T tmp(std::forward<Args>(args)...);
+      if (!Gap()) Grow();
+      MoveGap(ind);
+      Traits::construct(alloc, array + gap_begin, std::move(tmp));
+    } else {
+      Traits::construct(alloc, array + gap_begin, std::forward<Args>(args)...);
+    }
+    ++gap_begin;
+    return iterator(ind, this);
+  }
+  /**
+   * inserts value at index ind.
+   * throw index_out_of_bound if ind > size
+   */
+  iterator insert(const size_t &ind, const T &value) {
+    return emplace(ind, value);
+  }
+  iterator insert(const size_t &ind, T &&value) {
+    return emplace(ind, std::move(value));
+  }
+  iterator insert(iterator pos, const T &value) {
+    if (pos.source != this) throw invalid_iterator();
+    return emplace(pos.at, value);
+  }
+  iterator insert(iterator pos, T &&value) {
+    if (pos.source != this) throw invalid_iterator();
+    return emplace(pos.at, std::move(value));
+  }
+  /**
+   * removes the element with index ind, moving the gap there first.
+   * throw index_out_of_bound if ind >= size
+   */
+  iterator erase(const size_t &ind) {
+    if (ind >= size()) throw index_out_of_bound();
+    MoveGap(ind);
+    Destroy(array + gap_end++);
+    return iterator(ind, this);
+  }
+  iterator erase(iterator pos) {
+    if (pos.source != this || pos.at > size()) throw invalid_iterator();
+    return pos.at < size() ? erase(pos.at) : pos;
+  }
+
+  void push_back(const T &value) { emplace(size(), value); }
+  void push_back(T &&value) { emplace(size(), std::move(value)); }
+  /**
+   * throw container_is_empty if size() == 0
+   */
+  void pop_back() {
+    if (empty()) throw container_is_empty();
+    erase(size() - 1);
+  }
+};
+
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef SJTU_MAPPED_VECTOR_HPP
+#define SJTU_MAPPED_VECTOR_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * a vector of trivially copyable records kept in a file through mmap.
+ * the file is a plain array of T: opening maps it without reading or
+ * copying anything, and pages are loaded on first access.
+ * growth enlarges the file with ftruncate and remaps it; while the file is
+ * open it may carry unused capacity at its end, which close() cuts off.
+ *
+ * a read_only vector maps the file PROT_READ and refuses writes: the
+ * modifying operations (push_back, pop_back, resize, reserve, clear) throw
+ * runtime_error. the accessors work as usual, but storing through a
+ * reference or pointer they return faults, since the pages are read-only.
+ * I/O failures throw runtime_error.
+ */
+template <typename T>
+class mapped_vector {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "mapped_vector requires a trivially copyable type");
+
+ public:
+  enum open_mode { read_only, read_write };
+  using iterator = T *;
+  using const_iterator = const T *;
+
+ private:
+  int fd{-1};
+  bool writable{false};
+  T *array{nullptr};
+  size_t cur_size{0}, limit{0};  // 元素个数与当前映射的大小（以元素计）。
+
+  void CheckWritable() const {
+    if (!writable) throw runtime_error();
+  }
+  // 解除映射、截掉多余的容量并关闭文件，返回截断是否成功。
+  bool Release() {
+    if (fd < 0) return true;
+    if (array) munmap(array, limit * sizeof(T));
+    bool ok = !writable || limit == cur_size ||
+              !ftruncate(fd, cur_size * sizeof(T));
+    ::close(fd);
+    fd = -1, array = nullptr, cur_size = limit = 0;
+    return ok;
+  }
+  // 把文件截到 n 个元素的长度并重新映射。
+  void Remap(size_t n) {
+    if (ftruncate(fd, n * sizeof(T))) throw runtime_error();
+    void *p;
+    if (!n) {
+      p = nullptr;
+      if (array) munmap(array, limit * sizeof(T));
+    } else if (array) {
+#ifdef __linux__
+      p = mremap(array, limit * sizeof(T), n * sizeof(T), MREMAP_MAYMOVE);
+#else
+      munmap(array, limit * sizeof(T));
+      array = nullptr, limit = 0;  // 旧映射已经解除，失败时不能留下悬空指针。
+      p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+               0);
+#endif
+    } else {
+      p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+               0);
+    }
+    if (p == MAP_FAILED) throw runtime_error();
+    array = (T *)p, limit = n;
+  }
+
+ public:
+  mapped_vector() = default;
+  explicit mapped_vector(const char *path, open_mode mode = read_write) {
+    open(path, mode);
+  }
+  mapped_vector(const mapped_vector &) = delete;
+  mapped_vector(mapped_vector &&other) noexcept
+      : fd(other.fd),
+        writable(other.writable),
+        array(other.array),
+        cur_size(other.cur_size),
+        limit(other.limit) {
+    other.fd = -1, other.array = nullptr, other.cur_size = other.limit = 0;
+  }
+  ~mapped_vector() { Release(); }
+
+  mapped_vector &operator=(const mapped_vector &) = delete;
+  mapped_vector &operator=(mapped_vector &&other) noexcept {
+    if (&other != this) {
+      Release();
+      fd = other.fd, writable = other.writable, array = other.array;
+      cur_size = other.cur_size, limit = other.limit;
+      other.fd = -1, other.array = nullptr, other.cur_size = other.limit = 0;
+    }
+    return *this;
+  }
+
+  /**
+   * maps the file at path, creating it if it does not exist and mode is
+   * read_write. the file size must be a multiple of sizeof(T).
+   */
+  void open(const char *path, open_mode mode = read_write) {
+    close();
+    writable = mode == read_write;
+    fd = ::open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0) throw runtime_error();
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size % sizeof(T)) {
+      ::close(fd), fd = -1;
+      throw runtime_error();
+    }
+    cur_size = limit = st.st_size / sizeof(T);
+    if (limit) {
+      void *p = mmap(nullptr, limit * sizeof(T),
+                     writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                     fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd), fd = -1, cur_size = limit = 0;
+        throw runtime_error();
+      }
+      array = (T *)p;
+    }
+  }
+  /**
+   * unmaps the file and drops the unused capacity from it.
+   * throw runtime_error if the file could not be truncated; it is closed
+   * anyway, with the unused capacity left at its end. the destructor
+   * closes the same way but cannot report such a failure.
+   */
+  void close() {
+    if (!Release()) throw runtime_error();
+  }
+  /**
+   * writes dirty pages back to the file.
+   */
+  void sync() {
+    if (array && msync(array, limit * sizeof(T), MS_SYNC))
+      throw runtime_error();
+  }
+  bool is_open() const { return fd >= 0; }
+  bool is_read_only() const { return !writable; }
+
+  T &at(const size_t &pos) {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return array[pos];
+  }
+  const T &at(const size_t &pos) const {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return array[pos];
+  }
+  T &operator[](const size_t &pos) { return at(pos); }
+  const T &operator[](const size_t &pos) const { return at(pos); }
+
+  const T &front() const {
+    if (!cur_size) throw container_is_empty();
+    return array[0];
+  }
+  const T &back() const {
+    if (!cur_size) throw container_is_empty();
+    return array[cur_size - 1];
+  }
+
+  iterator begin() { return array; }
+  const_iterator begin() const { return array; }
+  const_iterator cbegin() const { return array; }
+  iterator end() { return array + cur_size; }
+  const_iterator end() const { return array + cur_size; }
+  const_iterator cend() const { return array + cur_size; }
+  T *data() { return array; }
+  const T *data() const { return array; }
+
+  bool empty() const { return !cur_size; }
+  size_t size() const { return cur_size; }
+  size_t capacity() const { return limit; }
+
+  void reserve(const size_t &n) {
+    CheckWritable();
+    if (n > limit) Remap(n);
+  }
+  /**
+   * new elements are filled with zero bytes.
+   */
+  void resize(const size_t &n) {
+    CheckWritable();
+    if (n > limit) Remap(n);
+    if (n > cur_size)
+      memset((void *)(array + cur_size), 0, (n - cur_size) * sizeof(T));
+    cur_size = n;
+  }
+  void clear() { resize(0); }
+
+  void push_back(const T &value) {
+    CheckWritable();
+    if (cur_size == limit) {
+      T tmp(value);  // 重新映射后 value 可能失效。
+      Remap(limit ? limit << 1 : 1);
+      array[cur_size++] = tmp;
+    } else {
+      array[cur_size++] = value;
+    }
+  }
+  /**
+   * throw container_is_empty if size() == 0
+   */
+  void pop_back() {
+    CheckWritable();
+    if (!cur_size) throw container_is_empty();
+    --cur_size;
+  }
+};
+
+}  // namespace sjtu
+
+#endif
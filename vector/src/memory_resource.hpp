@@ -0,0 +1,263 @@
+#ifndef SJTU_MEMORY_RESOURCE_HPP
+#define SJTU_MEMORY_RESOURCE_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * an abstract source of memory, like std::pmr::memory_resource.
+ * containers reach it through polymorphic_allocator, so the same container
+ * type can draw from the heap, an arena or a pool chosen at run time.
+ */
+class memory_resource {
+ public:
+  static constexpr size_t max_align = alignof(std::max_align_t);
+
+  virtual ~memory_resource() = default;
+
+  void *allocate(size_t bytes, size_t align = max_align) {
+    return do_allocate(bytes, align);
+  }
+  void deallocate(void *p, size_t bytes, size_t align = max_align) {
+    do_deallocate(p, bytes, align);
+  }
+  bool is_equal(const memory_resource &other) const noexcept {
+    return do_is_equal(other);
+  }
+
+ private:
+  virtual void *do_allocate(size_t bytes, size_t align) = 0;
+  virtual void do_deallocate(void *p, size_t bytes, size_t align) = 0;
+  virtual bool do_is_equal(const memory_resource &other) const noexcept {
+    return this == &other;
+  }
+};
+
+inline bool operator==(const memory_resource &a, const memory_resource &b) {
+  return &a == &b || a.is_equal(b);
+}
+inline bool operator!=(const memory_resource &a, const memory_resource &b) {
+  return !(a == b);
+}
+
+/**
+ * returns the resource that simply forwards to ::operator new / delete.
+ */
+inline memory_resource *new_delete_resource() {
+  class NewDeleteResource : public memory_resource {
+    void *do_allocate(size_t bytes, size_t align) override {
+      return ::operator new(bytes, std::align_val_t(align));
+    }
+    void do_deallocate(void *p, size_t, size_t align) override {
+      ::operator delete(p, std::align_val_t(align));
+    }
+  };
+  static NewDeleteResource res;
+  return &res;
+}
+
+/**
+ * an arena: memory is handed out by bumping a pointer through chunks taken
+ * from the upstream resource, deallocate() does nothing and everything is
+ * given back at once by release() or the destructor.
+ * not thread safe.
+ */
+class monotonic_buffer_resource : public memory_resource {
+  struct Chunk {
+    Chunk *nxt;
+    size_t bytes;  // 整块的大小，包括 Chunk 头。
+  } *chunks{nullptr};
+  memory_resource *upstream;
+  char *initial_buf;
+  size_t initial_size, next_size;
+  char *cur, *end;  // 当前块中尚未分配的部分。
+
+  void *do_allocate(size_t bytes, size_t align) override {
+    void *p = cur;
+    size_t space = end - cur;
+    if (!std::align(align, bytes, p, space)) {
+      // 当前块放不下，向上游申请一块足够大的新块，块大小按几何级数增长。
+      size_t need = sizeof(Chunk) + bytes + align;
+      while (next_size < need) next_size <<= 1;
+      Chunk *c = (Chunk *)upstream->allocate(next_size);
+      c->nxt = chunks, c->bytes = next_size, chunks = c;
+      cur = (char *)(c + 1), end = (char *)c + next_size;
+      next_size <<= 1;
+      p = cur, space = end - cur;
+      std::align(align, bytes, p, space);
+    }
+    cur = (char *)p + bytes;
+    return p;
+  }
+  void do_deallocate(void *, size_t, size_t) override {}
+
+ public:
+  explicit monotonic_buffer_resource(
+      size_t initial_size = 1024,
+      memory_resource *upstream = new_delete_resource())
+      : upstream(upstream),
+        initial_buf(nullptr),
+        initial_size(0),
+        next_size(initial_size < sizeof(Chunk) ? sizeof(Chunk) : initial_size),
+        cur(nullptr),
+        end(nullptr) {}
+  // 先用调用者提供的 buf，用完后再向上游申请。
+  monotonic_buffer_resource(void *buf, size_t size,
+                            memory_resource *upstream = new_delete_resource())
+      : upstream(upstream),
+        initial_buf((char *)buf),
+        initial_size(size),
+        next_size(size < sizeof(Chunk) ? sizeof(Chunk) : size),
+        cur((char *)buf),
+        end((char *)buf + size) {}
+  monotonic_buffer_resource(const monotonic_buffer_resource &) = delete;
+  monotonic_buffer_resource &operator=(const monotonic_buffer_resource &) =
+      delete;
+  ~monotonic_buffer_resource() override { release(); }
+
+  /**
+   * gives every chunk back to upstream; all memory handed out becomes
+   * invalid.
+   */
+  void release() {
+    while (chunks) {
+      Chunk *c = chunks;
+      chunks = c->nxt;
+      upstream->deallocate(c, c->bytes);
+    }
+    cur = initial_buf, end = initial_buf + initial_size;
+  }
+  memory_resource *upstream_resource() const { return upstream; }
+};
+
+/**
+ * a pool: requests up to 4 KiB are rounded up to a power of two
+ * and served from per-size free lists refilled from upstream in batches;
+ * larger requests go straight to upstream. freed blocks are reused, the
+ * batches themselves are only returned by release() or the destructor.
+ * not thread safe.
+ */
+class pool_resource : public memory_resource {
+  static constexpr size_t min_shift = 4, max_shift = 12;  // 16 B ~ 4 KiB
+  static constexpr size_t classes = max_shift - min_shift + 1;
+  static constexpr size_t batch = 64 * 1024;  // 每次向上游申请的大小。
+  static constexpr size_t batch_align = size_t(1) << max_shift;
+
+  struct Block {
+    Block *nxt;
+  } *free_list[classes]{};
+  struct Batch {
+    Batch *nxt;
+  } *batches{nullptr};
+  memory_resource *upstream;
+
+  static size_t Class(size_t bytes) {
+    size_t c = 0;
+    while ((size_t(1) << (c + min_shift)) < bytes) ++c;
+    return c;
+  }
+  void Refill(size_t c) {
+    size_t size = size_t(1) << (c + min_shift);
+    // 批次头占据第一个 block 的位置，保证其余 block 按其大小对齐。
+    Batch *b = (Batch *)upstream->allocate(batch, batch_align);
+    b->nxt = batches, batches = b;
+    for (size_t off = size; off + size <= batch; off += size) {
+      Block *blk = (Block *)((char *)b + off);
+      blk->nxt = free_list[c], free_list[c] = blk;
+    }
+  }
+
+  void *do_allocate(size_t bytes, size_t align) override {
+    if (bytes < align) bytes = align;  // 2 的幂大小的块天然按自身大小对齐。
+    if (bytes > (size_t(1) << max_shift))
+      return upstream->allocate(bytes, align);
+    size_t c = Class(bytes);
+    if (!free_list[c]) Refill(c);
+    Block *blk = free_list[c];
+    free_list[c] = blk->nxt;
+    return blk;
+  }
+  void do_deallocate(void *p, size_t bytes, size_t align) override {
+    if (bytes < align) bytes = align;
+    if (bytes > (size_t(1) << max_shift))
+      return upstream->deallocate(p, bytes, align);
+    size_t c = Class(bytes);
+    Block *blk = (Block *)p;
+    blk->nxt = free_list[c], free_list[c] = blk;
+  }
+
+ public:
+  explicit pool_resource(memory_resource *upstream = new_delete_resource())
+      : upstream(upstream) {}
+  pool_resource(const pool_resource &) = delete;
+  pool_resource &operator=(const pool_resource &) = delete;
+  ~pool_resource() override { release(); }
+
+  /**
+   * gives every batch back to upstream; all pooled memory becomes invalid.
+   * (blocks larger than the pool sizes must have been deallocated already.)
+   */
+  void release() {
+    while (batches) {
+      Batch *b = batches;
+      batches = b->nxt;
+      upstream->deallocate(b, batch, batch_align);
+    }
+    for (size_t c = 0; c < classes; ++c) free_list[c] = nullptr;
+  }
+  memory_resource *upstream_resource() const { return upstream; }
+};
+
+/**
+ * an allocator drawing from a memory_resource, like
+ * std::pmr::polymorphic_allocator. the resource is not propagated on
+ * container copy, move or swap.
+ */
+template <typename T>
+class polymorphic_allocator {
+  template <typename U>
+  friend class polymorphic_allocator;
+
+  memory_resource *res;
+
+ public:
+  using value_type = T;
+
+  polymorphic_allocator() noexcept : res(new_delete_resource()) {}
+  polymorphic_allocator(memory_resource *res) noexcept : res(res) {}
+  template <typename U>
+  polymorphic_allocator(const polymorphic_allocator<U> &other) noexcept
+      : res(other.res) {}
+  polymorphic_allocator &operator=(const polymorphic_allocator &) = delete;
+
+  T *allocate(size_t n) {
+    return (T *)res->allocate(n * sizeof(T), alignof(T));
+  }
+  void deallocate(T *p, size_t n) {
+    res->deallocate(p, n * sizeof(T), alignof(T));
+  }
+  // 容器拷贝时不继承资源，交给默认资源。
+  polymorphic_allocator select_on_container_copy_construction() const {
+    return polymorphic_allocator();
+  }
+  memory_resource *resource() const { return res; }
+
+  template <typename U>
+  bool operator==(const polymorphic_allocator<U> &rhs) const {
+    return *res == *rhs.res;
+  }
+  template <typename U>
+  bool operator!=(const polymorphic_allocator<U> &rhs) const {
+    return !(*this == rhs);
+  }
+};
+
+}  // namespace sjtu
+
+#endif
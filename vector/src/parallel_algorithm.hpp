@@ -0,0 +1,283 @@
+#ifndef SJTU_PARALLEL_ALGORITHM_HPP
+#define SJTU_PARALLEL_ALGORITHM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * parallel versions of sort / for_each / transform / reduce / inclusive_scan
+ * / partition over random access ranges, such as those of sjtu::vector.
+ * the work is cut into chunks run on a thread_pool (default_pool() unless
+ * one is given); ranges shorter than a chunk are handled on the calling
+ * thread. exceptions thrown by the callbacks are rethrown to the caller.
+ */
+namespace parallel {
+
+// 每块至少这么多元素，块数不超过并发数的 4 倍，以便负载均衡。
+constexpr size_t grain = 4096;
+
+inline size_t Chunks(size_t n, const thread_pool &pool) {
+  size_t k = n / grain, most = pool.concurrency() * 4;
+  if (k > most) k = most;
+  return k ? k : 1;
+}
+// 第 i 块的起点（共 k 块）。
+inline size_t Bound(size_t n, size_t k, size_t i) {
+  return n / k * i + std::min(i, n % k);
+}
+
+template <class RandomIt, class UnaryFunction>
+void for_each(RandomIt first, RandomIt last, UnaryFunction f,
+              thread_pool &pool = default_pool()) {
+  size_t n = last - first, k = Chunks(n, pool);
+  if (k == 1) return (void)std::for_each(first, last, f);
+  task_group tg(pool);
+  for (size_t i = 0; i < k; ++i)
+    tg.run([=, &f] {
+      std::for_each(first + Bound(n, k, i), first + Bound(n, k, i + 1), f);
+    });
+  tg.wait();
+}
+
+/**
+ * returns the end of the output range. the output may be the input itself.
+ */
+template <class RandomIt, class OutputIt, class UnaryOperation>
+OutputIt transform(RandomIt first, RandomIt last, OutputIt d_first,
+                   UnaryOperation op, thread_pool &pool = default_pool()) {
+  size_t n = last - first, k = Chunks(n, pool);
+  if (k == 1) return std::transform(first, last, d_first, op);
+  task_group tg(pool);
+  for (size_t i = 0; i < k; ++i)
+    tg.run([=, &op] {
+      size_t l = Bound(n, k, i), r = Bound(n, k, i + 1);
+      std::transform(first + l, first + r, d_first + l, op);
+    });
+  tg.wait();
+  return d_first + n;
+}
+
+/**
+ * op must be associative and commutative: the chunks are reduced
+ * separately and then combined with init.
+ */
+template <class RandomIt, class T, class BinaryOp = std::plus<>>
+T reduce(RandomIt first, RandomIt last, T init, BinaryOp op = BinaryOp(),
+         thread_pool &pool = default_pool()) {
+  size_t n = last - first, k = Chunks(n, pool);
+  if (k == 1) {
+    for (; first != last; ++first) init = op(std::move(init), *first);
+    return init;
+  }
+  vector<T> part;
+  part.resize(k, init);
+  task_group tg(pool);
+  for (size_t i = 0; i < k; ++i)
+    tg.run([=, &op, &part] {
+      RandomIt it = first + Bound(n, k, i), end = first + Bound(n, k, i + 1);
+      T acc = *it;
+      for (++it; it != end; ++it) acc = op(std::move(acc), *it);
+      part[i] = std::move(acc);
+    });
+  tg.wait();
+  for (size_t i = 0; i < k; ++i) init = op(std::move(init), part[i]);
+  return init;
+}
+
+/**
+ * d_first[i] = first[0] op ... op first[i]; op must be associative.
+ * the output may be the input itself. returns the end of the output range.
+ */
+template <class RandomIt, class OutputIt, class BinaryOp = std::plus<>>
+OutputIt inclusive_scan(RandomIt first, RandomIt last, OutputIt d_first,
+                        BinaryOp op = BinaryOp(),
+                        thread_pool &pool = default_pool()) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  size_t n = last - first, k = Chunks(n, pool);
+  auto Scan = [&op](RandomIt it, RandomIt end, OutputIt out, const T *carry) {
+    T acc = carry ? op(*carry, *it) : T(*it);
+    for (*out++ = acc, ++it; it != end; ++it, ++out) *out = acc = op(acc, *it);
+  };
+  if (!n) return d_first;
+  if (k == 1) return Scan(first, last, d_first, nullptr), d_first + n;
+  // 先并行求出各块之和，串行求前缀，再并行地带着前缀扫描每块。
+  vector<T> carry(k);
+  for (size_t i = 0; i + 1 < k; ++i) carry.push_back(first[Bound(n, k, i)]);
+  {
+    task_group tg(pool);
+    for (size_t i = 0; i + 1 < k; ++i)
+      tg.run([=, &op, &carry] {
+        RandomIt it = first + Bound(n, k, i) + 1;
+        RandomIt end = first + Bound(n, k, i + 1);
+        for (; it != end; ++it) carry[i] = op(carry[i], *it);
+      });
+    tg.wait();
+  }
+  for (size_t i = 1; i + 1 < k; ++i) carry[i] = op(carry[i - 1], carry[i]);
+  task_group tg(pool);
+  for (size_t i = 0; i < k; ++i)
+    tg.run([=, &Scan, &carry] {
+      size_t l = Bound(n, k, i), r = Bound(n, k, i + 1);
+      Scan(first + l, first + r, d_first + l, i ? &carry[i - 1] : nullptr);
+    });
+  tg.wait();
+  return d_first + n;
+}
+
+/**
+ * reorders the range so that the elements satisfying pred come first and
+ * returns the first element of the second group. not stable.
+ */
+template <class RandomIt, class UnaryPredicate>
+RandomIt partition(RandomIt first, RandomIt last, UnaryPredicate pred,
+                   thread_pool &pool = default_pool()) {
+  size_t n = last - first, k = Chunks(n, pool);
+  if (k == 1) return std::partition(first, last, pred);
+  // 先各块独立划分，得到 k 段“真-假”相间的序列。
+  vector<size_t> mid;
+  mid.resize(k);
+  {
+    task_group tg(pool);
+    for (size_t i = 0; i < k; ++i)
+      tg.run([=, &pred, &mid] {
+        mid[i] = std::partition(first + Bound(n, k, i),
+                                first + Bound(n, k, i + 1), pred) -
+                 first;
+      });
+    tg.wait();
+  }
+  size_t total = 0;
+  for (size_t i = 0; i < k; ++i) total += mid[i] - Bound(n, k, i);
+  // 落在 [0, total) 中的“假”段与落在 [total, n) 中的“真”段一样长，逐一交换。
+  struct Piece {
+    size_t begin, len, offset;  // offset 为此前各段的长度和。
+  };
+  vector<Piece> wrong_false, wrong_true;
+  size_t nf = 0, nt = 0;
+  for (size_t i = 0; i < k; ++i) {
+    size_t l = Bound(n, k, i), r = Bound(n, k, i + 1);
+    if (l < total) {  // [l, min(mid, total)) 为真，留在原地。
+      size_t b = mid[i], e = std::min(r, total);
+      if (b < e) wrong_false.push_back(Piece{b, e - b, nf}), nf += e - b;
+    }
+    if (r > total) {
+      size_t b = std::max(l, total), e = mid[i];
+      if (b < e) wrong_true.push_back(Piece{b, e - b, nt}), nt += e - b;
+    }
+  }
+  // 第 j 个待交换位置所在的段。
+  auto Locate = [](const vector<Piece> &v, size_t j) {
+    size_t lo = 0, hi = v.size();
+    while (hi - lo > 1) {
+      size_t m = (lo + hi) / 2;
+      (v[m].offset <= j ? lo : hi) = m;
+    }
+    return lo;
+  };
+  size_t s = Chunks(nf, pool);
+  task_group tg(pool);
+  for (size_t i = 0; i < s; ++i)
+    tg.run([=, &wrong_false, &wrong_true, &Locate] {
+      size_t j = Bound(nf, s, i), end = Bound(nf, s, i + 1);
+      size_t a = Locate(wrong_false, j), b = Locate(wrong_true, j);
+      while (j < end) {
+        const Piece &pa = wrong_false[a], &pb = wrong_true[b];
+        size_t step = std::min({end - j, pa.offset + pa.len - j,
+                                pb.offset + pb.len - j});
+        std::swap_ranges(first + (pa.begin + j - pa.offset),
+                         first + (pa.begin + j - pa.offset + step),
+                         first + (pb.begin + j - pb.offset));
+        j += step;
+        if (j == pa.offset + pa.len) ++a;
+        if (j == pb.offset + pb.len) ++b;
+      }
+    });
+  tg.wait();
+  return first + total;
+}
+
+template <class InputIt, class OutputIt, class Compare>
+void Merge(InputIt a, InputIt a_end, InputIt b, InputIt b_end, OutputIt out,
+           Compare &comp, thread_pool &pool) {
+  if (size_t((a_end - a) + (b_end - b)) <= grain)
+    return (void)std::merge(a, a_end, b, b_end, out, comp);
+  // 在较长的一段取中点，在另一段中二分出分界，两半互不相交，并行归并。
+  InputIt ma, mb;
+  if (a_end - a >= b_end - b)
+    ma = a + (a_end - a) / 2, mb = std::lower_bound(b, b_end, *ma, comp);
+  else
+    mb = b + (b_end - b) / 2, ma = std::lower_bound(a, a_end, *mb, comp);
+  OutputIt mo = out + ((ma - a) + (mb - b));
+  task_group tg(pool);
+  tg.run([=, &comp, &pool] { Merge(a, ma, b, mb, out, comp, pool); });
+  Merge(ma, a_end, mb, b_end, mo, comp, pool);
+  tg.wait();
+}
+
+/**
+ * sorts the range: the chunks are sorted in parallel and then merged pair
+ * by pair, each merge itself split across the pool. needs a buffer of n
+ * elements. not stable.
+ */
+template <class RandomIt, class Compare = std::less<>>
+void sort(RandomIt first, RandomIt last, Compare comp = Compare(),
+          thread_pool &pool = default_pool()) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  size_t n = last - first, k = Chunks(n, pool);
+  if (k == 1) return std::sort(first, last, comp);
+  {
+    task_group tg(pool);
+    for (size_t i = 0; i < k; ++i)
+      tg.run([=, &comp] {
+        std::sort(first + Bound(n, k, i), first + Bound(n, k, i + 1), comp);
+      });
+    tg.wait();
+  }
+  vector<T> buf;
+  buf.reserve(n);
+  buf.append(std::make_move_iterator(first), std::make_move_iterator(last));
+  // 每轮把相邻两段归并为一段，在原区间与 buf 之间来回。
+  vector<size_t> bounds(k + 1);
+  for (size_t i = 0; i <= k; ++i) bounds.push_back(Bound(n, k, i));
+  bool in_buf = true;
+  T *b = buf.data();
+  while (bounds.size() > 2) {
+    vector<size_t> merged(bounds.size() / 2 + 1);
+    task_group tg(pool);
+    for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+      size_t l = bounds[i], m = bounds[i + 1];
+      size_t r = i + 2 < bounds.size() ? bounds[i + 2] : m;
+      merged.push_back(l);
+      if (in_buf)
+        tg.run([=, &comp, &pool] {
+          auto src = std::make_move_iterator(b);
+          Merge(src + l, src + m, src + m, src + r, first + l, comp, pool);
+        });
+      else
+        tg.run([=, &comp, &pool] {
+          auto src = std::make_move_iterator(first);
+          Merge(src + l, src + m, src + m, src + r, b + l, comp, pool);
+        });
+    }
+    merged.push_back(n);
+    tg.wait();
+    bounds = std::move(merged);
+    in_buf = !in_buf;
+  }
+  if (in_buf)
+    parallel::transform(std::make_move_iterator(b),
+                        std::make_move_iterator(b + n), first,
+                        [](T &&x) -> T && { return std::move(x); }, pool);
+}
+
+}  // namespace parallel
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef SJTU_SEGMENTED_VECTOR_HPP
+#define SJTU_SEGMENTED_VECTOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a vector made of fixed-size chunks of ChunkSize elements, indexed through
+ * a directory (a sjtu::vector of chunk pointers).
+ * push_back never moves existing elements: growing only allocates a new
+ * chunk and occasionally grows the small directory, so element addresses
+ * stay valid until the element is removed and there is no transient
+ * 3x memory peak while growing.
+ */
+template <typename T, size_t ChunkSize = 1024>
+class segmented_vector {
+  static_assert(ChunkSize && !(ChunkSize & (ChunkSize - 1)),
+                "ChunkSize must be a power of 2");
+  static constexpr size_t Log2(size_t x) {
+    return x > 1 ? Log2(x >> 1) + 1 : 0;
+  }
+  static constexpr size_t shift = Log2(ChunkSize);
+  static constexpr size_t mask = ChunkSize - 1;
+
+  vector<T *> chunks;  // 目录，只在末尾增删整块。
+  size_t cur_size = 0;
+
+  static T *NewChunk() {
+    return (T *)::operator new(ChunkSize * sizeof(T),
+                               std::align_val_t(alignof(T)));
+  }
+  static void DeleteChunk(T *p) {
+    ::operator delete(p, std::align_val_t(alignof(T)));
+  }
+  void Release() {
+    clear();
+    for (size_t i = 0; i < chunks.size(); ++i) DeleteChunk(chunks[i]);
+    chunks.clear();
+  }
+
+  T &Get(size_t pos) const { return chunks.data()[pos >> shift][pos & mask]; }
+
+ public:
+  /**
+   * index based random access iterator; it stays valid as long as the
+   * element it refers to is not removed.
+   */
+  class const_iterator;
+  class iterator {
+    friend class segmented_vector;
+    friend class const_iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = T *;
+    using reference = T &;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    segmented_vector *source{nullptr};
+
+    iterator(size_t at, segmented_vector *source) : at(at), source(source) {}
+
+   public:
+    iterator() = default;
+
+    iterator operator+(const difference_type &n) const {
+      return iterator(at + n, source);
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
+      return iterator(at - n, source);
+    }
+    // if these two iterators point to different vectors, throw
+    // invaild_iterator.
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    iterator &operator+=(const difference_type &n) { return at += n, *this; }
+    iterator &operator-=(const difference_type &n) { return at -= n, *this; }
+
+    iterator operator++(int) { return iterator(at++, source); }
+    iterator &operator++() { return ++at, *this; }
+    iterator operator--(int) { return iterator(at--, source); }
+    iterator &operator--() { return --at, *this; }
+
+    T &operator*() const { return source->Get(at); }
+    T *operator->() const { return &source->Get(at); }
+    T &operator[](const difference_type &n) const { return *(*this + n); }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+  class const_iterator {
+    friend class segmented_vector;
+    friend class iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = const T *;
+    using reference = const T &;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    const segmented_vector *source{nullptr};
+
+    const_iterator(size_t at, const segmented_vector *source)
+        : at(at), source(source) {}
+
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &other)
+        : at(other.at), source(other.source) {}
+
+    const_iterator operator+(const difference_type &n) const {
+      return const_iterator(at + n, source);
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
+      return const_iterator(at - n, source);
+    }
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    const_iterator &operator+=(const difference_type &n) {
+      return at += n, *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      return at -= n, *this;
+    }
+
+    const_iterator operator++(int) { return const_iterator(at++, source); }
+    const_iterator &operator++() { return ++at, *this; }
+    const_iterator operator--(int) { return const_iterator(at--, source); }
+    const_iterator &operator--() { return --at, *this; }
+
+    const T &operator*() const { return source->Get(at); }
+    const T *operator->() const { return &source->Get(at); }
+    const T &operator[](const difference_type &n) const {
+      return *(*this + n);
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+
+  segmented_vector() = default;
+  segmented_vector(const segmented_vector &other) {
+    for (size_t i = 0; i < other.cur_size; ++i) push_back(other.Get(i));
+  }
+  segmented_vector(segmented_vector &&other) noexcept
+      : chunks(std::move(other.chunks)), cur_size(other.cur_size) {
+    other.cur_size = 0;
+  }
+  ~segmented_vector() { Release(); }
+
+  segmented_vector &operator=(const segmented_vector &other) {
+    if (&other != this) {
+      clear();
+      for (size_t i = 0; i < other.cur_size; ++i) push_back(other.Get(i));
+    }
+    return *this;
+  }
+  segmented_vector &operator=(segmented_vector &&other) noexcept {
+    if (&other != this) {
+      Release();
+      chunks = std::move(other.chunks);
+      cur_size = other.cur_size, other.cur_size = 0;
+    }
+    return *this;
+  }
+
+  T &at(const size_t &pos) {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return Get(pos);
+  }
+  const T &at(const size_t &pos) const {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return Get(pos);
+  }
+  T &operator[](const size_t &pos) { return at(pos); }
+  const T &operator[](const size_t &pos) const { return at(pos); }
+
+  const T &front() const {
+    if (!cur_size) throw container_is_empty();
+    return Get(0);
+  }
+  const T &back() const {
+    if (!cur_size) throw container_is_empty();
+    return Get(cur_size - 1);
+  }
+
+  iterator begin() { return iterator(0, this); }
+  const_iterator begin() const { return const_iterator(0, this); }
+  const_iterator cbegin() const { return const_iterator(0, this); }
+  iterator end() { return iterator(cur_size, this); }
+  const_iterator end() const { return const_iterator(cur_size, this); }
+  const_iterator cend() const { return const_iterator(cur_size, this); }
+
+  bool empty() const { return !cur_size; }
+  size_t size() const { return cur_size; }
+  size_t capacity() const { return chunks.size() << shift; }
+  /**
+   * clears the contents, keeping the allocated chunks.
+   */
+  void clear() {
+    while (cur_size) Get(--cur_size).~T();
+  }
+  /**
+   * releases the chunks no longer holding any element.
+   */
+  void shrink_to_fit() {
+    size_t need = (cur_size + mask) >> shift;
+    while (chunks.size() > need) {
+      DeleteChunk(chunks[chunks.size() - 1]);
+      chunks.pop_back();
+    }
+    chunks.shrink_to_fit();
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+  /**
+   * constructs an element at the end; no existing element is moved.
+   */
+  template <class... Args>
+  T &emplace_back(Args &&...args) {
+    if (cur_size == capacity()) chunks.push_back(NewChunk());
+    T *p = &Get(cur_size);
+    new (p) T(std::forward<Args>(args)...);
+    ++cur_size;
+    return *p;
+  }
+  /**
+   * throw container_is_empty if size() == 0
+   */
+  void pop_back() {
+    if (!cur_size) throw container_is_empty();
+    Get(--cur_size).~T();
+  }
+};
+
+}  // namespace sjtu
+
+#endif
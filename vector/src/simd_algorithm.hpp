@@ -0,0 +1,262 @@
+#ifndef SJTU_SIMD_ALGORITHM_HPP
+#define SJTU_SIMD_ALGORITHM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SJTU_SIMD_X86
+#endif
+
+namespace sjtu {
+/**
+ * vectorized find / count / min / max / sum over contiguous arrays of
+ * arithmetic types, for raw ranges and for sjtu::vector.
+ *
+ * each kernel is compiled for SSE2 and for AVX2; the widest one the CPU
+ * supports is picked once at run time, with a scalar fallback on other
+ * targets. floating point sums are added in a different order than a
+ * plain loop, so the result may differ in the last bits.
+ */
+namespace simd {
+
+// 32 位整数求和时放宽到 64 位，避免溢出；其它类型按自身类型求和。
+template <typename T>
+using sum_type = std::conditional_t<
+    std::is_integral<T>::value && sizeof(T) < sizeof(int64_t),
+    std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>, T>;
+
+/**
+ * the instruction set used by the kernels on this machine: 2 for AVX2,
+ * 1 for SSE2, 0 for scalar code.
+ */
+inline int level() {
+#ifdef SJTU_SIMD_X86
+  static const int lv = __builtin_cpu_supports("avx2")   ? 2
+                        : __builtin_cpu_supports("sse2") ? 1
+                                                         : 0;
+  return lv;
+#else
+  return 0;
+#endif
+}
+
+// 用 GCC 的向量扩展写一份与宽度无关的实现，Bytes 为一个寄存器的字节数。
+// 被内联进带 target 属性的入口函数后，由编译器生成对应指令集的代码。
+template <typename T, size_t Bytes>
+struct Kernels {
+  typedef T Reg __attribute__((vector_size(Bytes)));
+  using S = sum_type<T>;
+  typedef S Acc __attribute__((vector_size(Bytes / sizeof(T) * sizeof(S))));
+  static constexpr size_t w = Bytes / sizeof(T);
+
+  static const T *Find(const T *first, const T *last, T value) {
+    Reg v = value - Reg{};  // 广播。
+    for (; size_t(last - first) >= 4 * w; first += 4 * w) {
+      Reg a, b, c, d;
+      memcpy(&a, first, Bytes), memcpy(&b, first + w, Bytes);
+      memcpy(&c, first + 2 * w, Bytes), memcpy(&d, first + 3 * w, Bytes);
+      auto m = (a == v) | (b == v) | (c == v) | (d == v);
+      bool hit = false;
+      for (size_t i = 0; i < w; ++i) hit |= m[i] != 0;
+      if (hit) break;  // 命中的块交给下面的逐个比较。
+    }
+    for (; first != last; ++first)
+      if (*first == value) return first;
+    return last;
+  }
+  static size_t Count(const T *first, const T *last, T value) {
+    Reg v = value - Reg{};
+    auto cnt = (v != v);  // 各通道为 0 的比较结果类型。
+    size_t ret = 0;
+    while (size_t(last - first) >= w) {
+      // 比较结果为 -1，减去它即计数；通道可能只有 8 位，每 127 轮清空一次。
+      size_t batch = (last - first) / w;
+      if (batch > 127) batch = 127;
+      for (size_t k = 0; k < batch; ++k, first += w) {
+        Reg a;
+        memcpy(&a, first, Bytes);
+        cnt -= (a == v);
+      }
+      for (size_t i = 0; i < w; ++i) ret += cnt[i];
+      cnt = (v != v);
+    }
+    for (; first != last; ++first) ret += *first == value;
+    return ret;
+  }
+  // 需保证区间非空。
+  static T Min(const T *first, const T *last) {
+    T ret = *first;
+    if (size_t(last - first) >= w) {
+      Reg acc;
+      memcpy(&acc, first, Bytes);
+      for (first += w; size_t(last - first) >= w; first += w) {
+        Reg a;
+        memcpy(&a, first, Bytes);
+        acc = a < acc ? a : acc;
+      }
+      for (size_t i = 0; i < w; ++i)
+        if (acc[i] < ret) ret = acc[i];
+    }
+    for (; first != last; ++first)
+      if (*first < ret) ret = *first;
+    return ret;
+  }
+  static T Max(const T *first, const T *last) {
+    T ret = *first;
+    if (size_t(last - first) >= w) {
+      Reg acc;
+      memcpy(&acc, first, Bytes);
+      for (first += w; size_t(last - first) >= w; first += w) {
+        Reg a;
+        memcpy(&a, first, Bytes);
+        acc = a > acc ? a : acc;
+      }
+      for (size_t i = 0; i < w; ++i)
+        if (acc[i] > ret) ret = acc[i];
+    }
+    for (; first != last; ++first)
+      if (*first > ret) ret = *first;
+    return ret;
+  }
+  static S Sum(const T *first, const T *last) {
+    Acc acc0{}, acc1{};  // 两个累加器，隐藏加法延迟。
+    for (; size_t(last - first) >= 2 * w; first += 2 * w) {
+      Reg a, b;
+      memcpy(&a, first, Bytes), memcpy(&b, first + w, Bytes);
+      acc0 += __builtin_convertvector(a, Acc);
+      acc1 += __builtin_convertvector(b, Acc);
+    }
+    acc0 += acc1;
+    S ret = 0;
+    for (size_t i = 0; i < w; ++i) ret += acc0[i];
+    for (; first != last; ++first) ret += *first;
+    return ret;
+  }
+};
+
+#ifdef SJTU_SIMD_X86
+#define SJTU_SIMD_ENTRY(isa, bytes)                                        \
+  template <typename T>                                                    \
+  __attribute__((target(#isa), flatten)) const T *Find_##isa(              \
+      const T *first, const T *last, T value) {                            \
+    return Kernels<T, bytes>::Find(first, last, value);                    \
+  }                                                                        \
+  template <typename T>                                                    \
+  __attribute__((target(#isa), flatten)) size_t Count_##isa(               \
+      const T *first, const T *last, T value) {                            \
+    return Kernels<T, bytes>::Count(first, last, value);                   \
+  }                                                                        \
+  template <typename T>                                                    \
+  __attribute__((target(#isa), flatten)) T Min_##isa(const T *first,       \
+                                                     const T *last) {      \
+    return Kernels<T, bytes>::Min(first, last);                            \
+  }                                                                        \
+  template <typename T>                                                    \
+  __attribute__((target(#isa), flatten)) T Max_##isa(const T *first,       \
+                                                     const T *last) {      \
+    return Kernels<T, bytes>::Max(first, last);                            \
+  }                                                                        \
+  template <typename T>                                                    \
+  __attribute__((target(#isa), flatten)) sum_type<T> Sum_##isa(            \
+      const T *first, const T *last) {                                     \
+    return Kernels<T, bytes>::Sum(first, last);                            \
+  }
+SJTU_SIMD_ENTRY(sse2, 16)
+SJTU_SIMD_ENTRY(avx2, 32)
+#undef SJTU_SIMD_ENTRY
+
+#define SJTU_SIMD_DISPATCH(op, ...)                     \
+  switch (level()) {                                    \
+    case 2:                                             \
+      return op##_avx2(__VA_ARGS__);                    \
+    case 1:                                             \
+      return op##_sse2(__VA_ARGS__);                    \
+    default:                                            \
+      return Kernels<T, sizeof(T)>::op(__VA_ARGS__);    \
+  }
+#else
+#define SJTU_SIMD_DISPATCH(op, ...) \
+  return Kernels<T, sizeof(T)>::op(__VA_ARGS__);
+#endif
+
+template <typename T>
+using RequireArithmetic = std::enable_if_t<std::is_arithmetic<T>::value &&
+                                           !std::is_same<T, bool>::value>;
+
+/**
+ * returns a pointer to the first element equal to value, or last.
+ */
+template <typename T, class = RequireArithmetic<T>>
+const T *find(const T *first, const T *last, const T &value) {
+  SJTU_SIMD_DISPATCH(Find, first, last, value)
+}
+/**
+ * returns the number of elements equal to value.
+ */
+template <typename T, class = RequireArithmetic<T>>
+size_t count(const T *first, const T *last, const T &value) {
+  SJTU_SIMD_DISPATCH(Count, first, last, value)
+}
+/**
+ * returns the smallest element.
+ * throw container_is_empty if the range is empty.
+ */
+template <typename T, class = RequireArithmetic<T>>
+T min(const T *first, const T *last) {
+  if (first == last) throw container_is_empty();
+  SJTU_SIMD_DISPATCH(Min, first, last)
+}
+/**
+ * returns the largest element.
+ * throw container_is_empty if the range is empty.
+ */
+template <typename T, class = RequireArithmetic<T>>
+T max(const T *first, const T *last) {
+  if (first == last) throw container_is_empty();
+  SJTU_SIMD_DISPATCH(Max, first, last)
+}
+/**
+ * returns the sum of the elements (32-bit and smaller integers are summed
+ * in 64 bits).
+ */
+template <typename T, class = RequireArithmetic<T>>
+sum_type<T> sum(const T *first, const T *last) {
+  SJTU_SIMD_DISPATCH(Sum, first, last)
+}
+#undef SJTU_SIMD_DISPATCH
+
+/**
+ * overloads for sjtu::vector. find returns the index of the first element
+ * equal to value, or size() if there is none.
+ */
+template <typename T, class A, class G, class = RequireArithmetic<T>>
+size_t find(const vector<T, A, G> &v, const T &value) {
+  return find(v.data(), v.data() + v.size(), value) - v.data();
+}
+template <typename T, class A, class G, class = RequireArithmetic<T>>
+size_t count(const vector<T, A, G> &v, const T &value) {
+  return count(v.data(), v.data() + v.size(), value);
+}
+template <typename T, class A, class G, class = RequireArithmetic<T>>
+T min(const vector<T, A, G> &v) {
+  return min(v.data(), v.data() + v.size());
+}
+template <typename T, class A, class G, class = RequireArithmetic<T>>
+T max(const vector<T, A, G> &v) {
+  return max(v.data(), v.data() + v.size());
+}
+template <typename T, class A, class G, class = RequireArithmetic<T>>
+sum_type<T> sum(const vector<T, A, G> &v) {
+  return sum(v.data(), v.data() + v.size());
+}
+
+}  // namespace simd
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef SJTU_SMALL_VECTOR_HPP
+#define SJTU_SMALL_VECTOR_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * an allocator owning an inline buffer of N objects of type T.
+ * the first request of at most N objects is served from the buffer, all
+ * others (and requests made while the buffer is in use) from the heap.
+ *
+ * the buffer lives inside the allocator, so a copy of the allocator gets a
+ * fresh empty buffer and two allocators never compare equal: containers
+ * then move elements one by one instead of taking over each other's
+ * storage.
+ */
+template <typename T, size_t N>
+class inline_allocator {
+  alignas(T) unsigned char buf[N * sizeof(T)];
+  bool used{false};
+
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::false_type;
+  using propagate_on_container_swap = std::false_type;
+  using is_always_equal = std::false_type;
+  template <typename U>
+  struct rebind {
+    using other = inline_allocator<U, N>;
+  };
+
+  inline_allocator() {}
+  inline_allocator(const inline_allocator &) {}  // 内置空间不随之复制。
+  template <typename U>
+  inline_allocator(const inline_allocator<U, N> &) {}
+  inline_allocator &operator=(const inline_allocator &) { return *this; }
+
+  T *allocate(size_t n) {
+    if (!used && n <= N) return used = true, (T *)buf;
+    return allocator<T>().allocate(n);
+  }
+  void deallocate(T *p, size_t n) {
+    if (p == (T *)buf)
+      used = false;
+    else
+      allocator<T>().deallocate(p, n);
+  }
+
+  bool operator==(const inline_allocator &rhs) const { return this == &rhs; }
+  bool operator!=(const inline_allocator &rhs) const { return this != &rhs; }
+};
+
+/**
+ * a vector keeping up to N elements inline and spilling to the heap only
+ * past that. it has the whole interface of sjtu::vector.
+ * moving a small_vector moves its elements one by one, since inline
+ * storage cannot change hands.
+ */
+template <typename T, size_t N, class Growth = double_growth>
+class small_vector : public vector<T, inline_allocator<T, N>, Growth> {
+  using Base = vector<T, inline_allocator<T, N>, Growth>;
+
+ public:
+  small_vector() : Base(N) {}
+  small_vector(const small_vector &other) : Base(N) {
+    this->append(other.begin(), other.end());
+  }
+  small_vector(small_vector &&other) : Base(N) {
+    Base::operator=(std::move(other));
+  }
+
+  small_vector &operator=(const small_vector &other) {
+    return Base::operator=(other), *this;
+  }
+  small_vector &operator=(small_vector &&other) {
+    return Base::operator=(std::move(other)), *this;
+  }
+};
+
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,361 @@
+#ifndef SJTU_SOA_VECTOR_HPP
+#define SJTU_SOA_VECTOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+#include "span.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a structure-of-arrays container: the i-th field of every record is kept
+ * in its own sjtu::vector, so a loop over one field streams through a
+ * single contiguous array (and can be vectorized) instead of dragging
+ * whole records through the cache.
+ *
+ * rows are accessed through proxies: at(i).get<k>() is field k of row i.
+ * column<k>() is a span over field k of every row; it is invalidated by
+ * any insertion or removal, like an iterator of vector.
+ *
+ * vector<bool> packs bits and has no data(), so a bool field is stored as
+ * soa_vector::flag, a one-byte wrapper converting to and from bool; get<k>()
+ * and column<k>() of such a field hand out flag rather than bool.
+ */
+template <typename... Fields>
+class soa_vector {
+  static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+  static constexpr size_t n_fields = sizeof...(Fields);
+
+ public:
+  using value_type = std::tuple<Fields...>;
+  template <size_t I>
+  using field_type = std::tuple_element_t<I, value_type>;
+
+  /**
+   * the stored form of a bool field.
+   */
+  struct flag {
+    bool value;
+    flag(bool value) : value(value) {}
+    operator bool() const { return value; }
+  };
+  static_assert(sizeof(flag) == sizeof(bool) && alignof(flag) == alignof(bool),
+                "a flag column must take one bool per row");
+  /**
+   * the type stored in column I: flag for a bool field, else the field type.
+   */
+  template <size_t I>
+  using column_type =
+      std::conditional_t<std::is_same<field_type<I>, bool>::value, flag,
+                         field_type<I>>;
+
+ private:
+  template <typename F>
+  using Column =
+      vector<std::conditional_t<std::is_same<F, bool>::value, flag, F>>;
+
+  std::tuple<Column<Fields>...> columns;
+
+  // 第 I 列的连续存储。
+  template <size_t I>
+  column_type<I> *Data() { return std::get<I>(columns).data(); }
+  template <size_t I>
+  const column_type<I> *Data() const { return std::get<I>(columns).data(); }
+  template <size_t... I>
+  static value_type Row(const soa_vector &v, size_t pos,
+                        std::index_sequence<I...>) {
+    return value_type(v.Data<I>()[pos]...);
+  }
+  // 逐列追加 t 的各个字段；某一列失败时撤销已追加的列，保证各列等长。
+  template <size_t I = 0, class Tuple>
+  void PushFrom(Tuple &&t) {
+    if constexpr (I < n_fields) {
+      std::get<I>(columns).push_back(std::get<I>(std::forward<Tuple>(t)));
+      try {
+        PushFrom<I + 1>(std::forward<Tuple>(t));
+      } catch (...) {
+        std::get<I>(columns).pop_back();
+        throw;
+      }
+    }
+  }
+  template <class F, size_t... I>
+  void ForEachColumn(F &&f, std::index_sequence<I...>) {
+    (f(std::get<I>(columns)), ...);
+  }
+  template <class F>
+  void ForEachColumn(F &&f) {
+    ForEachColumn(std::forward<F>(f), std::index_sequence_for<Fields...>());
+  }
+
+ public:
+  /**
+   * a proxy standing for one row.
+   */
+  class reference {
+    friend class soa_vector;
+
+    soa_vector *source;
+    size_t at;
+
+    reference(soa_vector *source, size_t at) : source(source), at(at) {}
+
+   public:
+    template <size_t I>
+    column_type<I> &get() const {
+      return source->template Data<I>()[at];
+    }
+    operator value_type() const {
+      return Row(*source, at, std::index_sequence_for<Fields...>());
+    }
+    const reference &operator=(const value_type &t) const {
+      Assign(t, std::index_sequence_for<Fields...>());
+      return *this;
+    }
+    const reference &operator=(const reference &other) const {
+      return *this = value_type(other);
+    }
+
+   private:
+    template <size_t... I>
+    void Assign(const value_type &t, std::index_sequence<I...>) const {
+      ((get<I>() = std::get<I>(t)), ...);
+    }
+  };
+  class const_reference {
+    friend class soa_vector;
+
+    const soa_vector *source;
+    size_t at;
+
+    const_reference(const soa_vector *source, size_t at)
+        : source(source), at(at) {}
+
+   public:
+    const_reference(const reference &other)
+        : source(other.source), at(other.at) {}
+
+    template <size_t I>
+    const column_type<I> &get() const {
+      return source->template Data<I>()[at];
+    }
+    operator value_type() const {
+      return Row(*source, at, std::index_sequence_for<Fields...>());
+    }
+  };
+
+  /**
+   * index based random access iterators; * yields a row proxy.
+   */
+  class const_iterator;
+  class iterator {
+    friend class soa_vector;
+    friend class const_iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename soa_vector::value_type;
+    using pointer = void;
+    using reference = typename soa_vector::reference;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    soa_vector *source{nullptr};
+
+    iterator(size_t at, soa_vector *source) : at(at), source(source) {}
+
+   public:
+    iterator() = default;
+
+    iterator operator+(const difference_type &n) const {
+      return iterator(at + n, source);
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
+      return iterator(at - n, source);
+    }
+    // if these two iterators point to different vectors, throw
+    // invaild_iterator.
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    iterator &operator+=(const difference_type &n) { return at += n, *this; }
+    iterator &operator-=(const difference_type &n) { return at -= n, *this; }
+
+    iterator operator++(int) { return iterator(at++, source); }
+    iterator &operator++() { return ++at, *this; }
+    iterator operator--(int) { return iterator(at--, source); }
+    iterator &operator--() { return --at, *this; }
+
+    reference operator*() const { return reference(source, at); }
+    reference operator[](const difference_type &n) const {
+      return *(*this + n);
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+  class const_iterator {
+    friend class soa_vector;
+    friend class iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename soa_vector::value_type;
+    using pointer = void;
+    using reference = typename soa_vector::const_reference;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    const soa_vector *source{nullptr};
+
+    const_iterator(size_t at, const soa_vector *source)
+        : at(at), source(source) {}
+
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &other)
+        : at(other.at), source(other.source) {}
+
+    const_iterator operator+(const difference_type &n) const {
+      return const_iterator(at + n, source);
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
+      return const_iterator(at - n, source);
+    }
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    const_iterator &operator+=(const difference_type &n) {
+      return at += n, *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      return at -= n, *this;
+    }
+
+    const_iterator operator++(int) { return const_iterator(at++, source); }
+    const_iterator &operator++() { return ++at, *this; }
+    const_iterator operator--(int) { return const_iterator(at--, source); }
+    const_iterator &operator--() { return --at, *this; }
+
+    const_reference operator*() const { return const_reference(source, at); }
+    const_reference operator[](const difference_type &n) const {
+      return *(*this + n);
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+
+  soa_vector() = default;
+
+  /**
+   * throw index_out_of_bound if pos >= size
+   */
+  reference at(const size_t &pos) {
+    if (pos >= size()) throw index_out_of_bound();
+    return reference(this, pos);
+  }
+  const_reference at(const size_t &pos) const {
+    if (pos >= size()) throw index_out_of_bound();
+    return const_reference(this, pos);
+  }
+  reference operator[](const size_t &pos) { return at(pos); }
+  const_reference operator[](const size_t &pos) const { return at(pos); }
+
+  /**
+   * the I-th field of every row, as one contiguous array.
+   */
+  template <size_t I>
+  span<column_type<I>> column() {
+    return span<column_type<I>>(Data<I>(), size());
+  }
+  template <size_t I>
+  span<const column_type<I>> column() const {
+    return span<const column_type<I>>(Data<I>(), size());
+  }
+
+  iterator begin() { return iterator(0, this); }
+  const_iterator begin() const { return const_iterator(0, this); }
+  const_iterator cbegin() const { return const_iterator(0, this); }
+  iterator end() { return iterator(size(), this); }
+  const_iterator end() const { return const_iterator(size(), this); }
+  const_iterator cend() const { return const_iterator(size(), this); }
+
+  bool empty() const { return !size(); }
+  size_t size() const { return std::get<0>(columns).size(); }
+  void reserve(const size_t &n) {
+    ForEachColumn([&n](auto &col) { col.reserve(n); });
+  }
+  void shrink_to_fit() {
+    ForEachColumn([](auto &col) { col.shrink_to_fit(); });
+  }
+  void clear() {
+    ForEachColumn([](auto &col) { col.clear(); });
+  }
+
+  /**
+   * appends a row made of one value per field.
+   */
+  void push_back(const value_type &row) { PushFrom(row); }
+  void push_back(value_type &&row) { PushFrom(std::move(row)); }
+  template <class... Args,
+            class = std::enable_if_t<sizeof...(Args) == n_fields>>
+  void emplace_back(Args &&...args) {
+    PushFrom(std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+  /**
+   * removes the row with index ind.
+   * throw index_out_of_bound if ind >= size
+   */
+  void erase(const size_t &ind) {
+    if (ind >= size()) throw index_out_of_bound();
+    ForEachColumn([&ind](auto &col) { col.erase(ind); });
+  }
+  /**
+   * removes the row at pos; returns an iterator to the following row.
+   */
+  iterator erase(iterator pos) {
+    if (pos.source != this || pos.at > size()) throw invalid_iterator();
+    if (pos.at < size()) erase(pos.at);
+    return pos;
+  }
+  /**
+   * throw container_is_empty if size() == 0
+   */
+  void pop_back() {
+    if (empty()) throw container_is_empty();
+    ForEachColumn([](auto &col) { col.pop_back(); });
+  }
+};
+
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef SJTU_SPAN_HPP
+#define SJTU_SPAN_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "exceptions.hpp"
+
+namespace sjtu {
+/**
+ * a view of a contiguous array: a pointer and a length.
+ */
+template <typename T>
+class span {
+  T *ptr{nullptr};
+  size_t len{0};
+
+ public:
+  using value_type = std::remove_cv_t<T>;
+  using iterator = T *;
+
+  span() = default;
+  span(T *ptr, size_t len) : ptr(ptr), len(len) {}
+  template <typename U, class = std::enable_if_t<
+                            std::is_convertible<U (*)[], T (*)[]>::value>>
+  span(const span<U> &other) : ptr(other.data()), len(other.size()) {}
+
+  /**
+   * throw index_out_of_bound if pos >= size
+   */
+  T &at(const size_t &pos) const {
+    if (pos >= len) throw index_out_of_bound();
+    return ptr[pos];
+  }
+  T &operator[](const size_t &pos) const { return ptr[pos]; }
+  T *data() const { return ptr; }
+  size_t size() const { return len; }
+  bool empty() const { return !len; }
+  iterator begin() const { return ptr; }
+  iterator end() const { return ptr + len; }
+};
+
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef SJTU_STATIC_VECTOR_HPP
+#define SJTU_STATIC_VECTOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "exceptions.hpp"
+
+namespace sjtu {
+// 平凡类型直接存放一个值初始化的数组：所有操作都能在常量表达式中进行，
+// 整个对象也是平凡可复制的。代价是构造时清零全部 N 个元素，拷贝时也复制
+// 全部 N 个；C++17 的 constexpr 构造函数必须初始化每个成员，无法省去清零。
+template <typename T, size_t N, bool = std::is_trivial<T>::value>
+class StaticStorage {
+ protected:
+  T elems[N]{};
+  size_t cur_size = 0;
+
+  constexpr T *Data() { return elems; }
+  constexpr const T *Data() const { return elems; }
+  template <class... Args>
+  constexpr void Construct(size_t i, Args &&...args) {
+    if constexpr (std::is_constructible<T, Args...>::value)
+      elems[i] = T(std::forward<Args>(args)...);
+    else
+      elems[i] = T{std::forward<Args>(args)...};
+  }
+  constexpr void Destroy(size_t) {}
+};
+
+// 其余类型放在未初始化的原始空间里，按需构造与析构。
+template <typename T, size_t N>
+class StaticStorage<T, N, false> {
+  alignas(T) unsigned char buf[N * sizeof(T)];
+
+  // 在空的 *this 上逐个构造 other 的元素（S 为右值时移动）。
+  template <class S>
+  void Fill(S &&other) {
+    using Ref = std::conditional_t<std::is_lvalue_reference<S>::value,
+                                   const T &, T &&>;
+    try {
+      for (; cur_size < other.cur_size; ++cur_size)
+        Construct(cur_size, static_cast<Ref>(other.Data()[cur_size]));
+    } catch (...) {
+      Clear();
+      throw;
+    }
+  }
+  void Clear() {
+    for (size_t i = 0; i < cur_size; ++i) Destroy(i);
+    cur_size = 0;
+  }
+
+ protected:
+  size_t cur_size = 0;
+
+  T *Data() { return std::launder(reinterpret_cast<T *>(buf)); }
+  const T *Data() const {
+    return std::launder(reinterpret_cast<const T *>(buf));
+  }
+  template <class... Args>
+  void Construct(size_t i, Args &&...args) {
+    new (Data() + i) T(std::forward<Args>(args)...);
+  }
+  void Destroy(size_t i) { Data()[i].~T(); }
+
+ public:
+  StaticStorage() {}
+  StaticStorage(const StaticStorage &other) { Fill(other); }
+  StaticStorage(StaticStorage &&other) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    Fill(std::move(other));
+  }
+  ~StaticStorage() { Clear(); }
+
+  StaticStorage &operator=(const StaticStorage &other) {
+    if (this != &other) Clear(), Fill(other);
+    return *this;
+  }
+  StaticStorage &operator=(StaticStorage &&other) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    if (this != &other) Clear(), Fill(std::move(other));
+    return *this;
+  }
+};
+
+/**
+ * a vector holding at most N elements in storage inside the object itself,
+ * so it never touches the allocator. the behavior matches sjtu::vector
+ * (index_out_of_bound, container_is_empty, invalid_iterator), and every
+ * operation that would need more than N elements throws capacity_exceeded
+ * instead of growing.
+ *
+ * the object owns no pointers, so it can be placed in shared memory and
+ * stays valid in a forked child. for trivial T the elements are
+ * value-initialized up front, every member function is constexpr, and the
+ * whole static_vector is trivially copyable, i.e. may be copied with
+ * memcpy. the price is O(N) rather than O(size()) work: constructing one
+ * zero-fills all N elements, and copying or moving one copies all of them.
+ * (C++17 does not allow leaving the array uninitialized in a constexpr
+ * constructor.) for a large N that is mostly empty, prefer sjtu::vector.
+ *
+ * iterators are plain pointers.
+ */
+template <typename T, size_t N>
+class static_vector : private StaticStorage<T, N> {
+  static_assert(N > 0, "static_vector needs a positive capacity");
+  using Base = StaticStorage<T, N>;
+  using Base::Construct;
+  using Base::cur_size;
+  using Base::Data;
+  using Base::Destroy;
+
+  // 迭代器对应的下标，迭代器不在 [begin(), end()] 内时抛出 invalid_iterator.
+  constexpr size_t Index(const T *pos) const {
+    if (pos < Data() || pos > Data() + cur_size) throw invalid_iterator();
+    return pos - Data();
+  }
+  // 删除 [ind, ind + n) 的元素，之后的元素整体前移 n 位。
+  constexpr void ShiftLeft(size_t ind, size_t n) {
+    for (size_t i = ind; i + n < cur_size; ++i)
+      Data()[i] = std::move(Data()[i + n]);
+    for (size_t i = cur_size - n; i < cur_size; ++i) Destroy(i);
+    cur_size -= n;
+  }
+  // 下标重载只接受整数类型：iterator 是指针，字面量 0 又是空指针常量，
+  // 不加限制时 insert(0, x) 与 erase(0) 会和迭代器重载产生歧义。
+  template <class I>
+  using IfIndex = std::enable_if_t<std::is_integral<I>::value, int>;
+
+ public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  constexpr static_vector() = default;
+
+  /**
+   * throw index_out_of_bound if pos >= size
+   */
+  constexpr T &at(const size_t &pos) {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return Data()[pos];
+  }
+  constexpr const T &at(const size_t &pos) const {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return Data()[pos];
+  }
+  constexpr T &operator[](const size_t &pos) { return at(pos); }
+  constexpr const T &operator[](const size_t &pos) const { return at(pos); }
+
+  /**
+   * throw container_is_empty if size == 0
+   */
+  constexpr T &front() {
+    if (!cur_size) throw container_is_empty();
+    return Data()[0];
+  }
+  constexpr const T &front() const {
+    if (!cur_size) throw container_is_empty();
+    return Data()[0];
+  }
+  constexpr T &back() {
+    if (!cur_size) throw container_is_empty();
+    return Data()[cur_size - 1];
+  }
+  constexpr const T &back() const {
+    if (!cur_size) throw container_is_empty();
+    return Data()[cur_size - 1];
+  }
+
+  constexpr iterator begin() { return Data(); }
+  constexpr const_iterator begin() const { return Data(); }
+  constexpr const_iterator cbegin() const { return Data(); }
+  constexpr iterator end() { return Data() + cur_size; }
+  constexpr const_iterator end() const { return Data() + cur_size; }
+  constexpr const_iterator cend() const { return Data() + cur_size; }
+
+  constexpr T *data() { return Data(); }
+  constexpr const T *data() const { return Data(); }
+
+  constexpr bool empty() const { return !cur_size; }
+  constexpr bool full() const { return cur_size == N; }
+  constexpr size_t size() const { return cur_size; }
+  static constexpr size_t capacity() { return N; }
+
+  /**
+   * resizes the container to contain n elements, appending value-initialized
+   * elements (or copies of value) if it grows.
+   * throw capacity_exceeded if n > capacity
+   */
+  constexpr void resize(const size_t &n) {
+    if (n > N) throw capacity_exceeded();
+    if (n <= cur_size) return ShiftLeft(n, cur_size - n);
+    for (; cur_size < n; ++cur_size) Construct(cur_size);
+  }
+  constexpr void resize(const size_t &n, const T &value) {
+    if (n > N) throw capacity_exceeded();
+    if (n <= cur_size) return ShiftLeft(n, cur_size - n);
+    for (; cur_size < n; ++cur_size) Construct(cur_size, value);
+  }
+  constexpr void clear() { ShiftLeft(0, cur_size); }
+
+  /**
+   * inserts value before pos
+   * returns an iterator pointing to the inserted value.
+   * throw capacity_exceeded if the vector is full
+   */
+  constexpr iterator insert(const_iterator pos, const T &value) {
+    return emplace(Index(pos), value);
+  }
+  constexpr iterator insert(const_iterator pos, T &&value) {
+    return emplace(Index(pos), std::move(value));
+  }
+  /**
+   * inserts value at index ind.
+   * throw index_out_of_bound if ind > size
+   * throw capacity_exceeded if the vector is full
+   */
+  template <class I, IfIndex<I> = 0>
+  constexpr iterator insert(I ind, const T &value) {
+    return emplace(size_t(ind), value);
+  }
+  template <class I, IfIndex<I> = 0>
+  constexpr iterator insert(I ind, T &&value) {
+    return emplace(size_t(ind), std::move(value));
+  }
+  template <class... Args>
+  constexpr iterator emplace(const_iterator pos, Args &&...args) {
+    return emplace(Index(pos), std::forward<Args>(args)...);
+  }
+  template <class I, IfIndex<I> = 0, class... Args>
+  constexpr iterator emplace(I i, Args &&...args) {
+    size_t ind = i;
+    if (ind > cur_size) throw index_out_of_bound();
+    // 先在末尾构造（参数可能引用本容器中的元素），再转到 ind 处。
+    emplace_back(std::forward<Args>(args)...);
+    if (ind + 1 < cur_size) {
+      T tmp(std::move(Data()[cur_size - 1]));
+      for (size_t i = cur_size - 1; i > ind; --i)
+        Data()[i] = std::move(Data()[i - 1]);
+      Data()[ind] = std::move(tmp);
+    }
+    return Data() + ind;
+  }
+
+  /**
+   * removes the element at pos.
+   * return an iterator pointing to the following element.
+   */
+  constexpr iterator erase(const_iterator pos) {
+    size_t ind = Index(pos);
+    if (ind < cur_size) ShiftLeft(ind, 1);
+    return Data() + ind;
+  }
+  /**
+   * removes the element with index ind.
+   * throw index_out_of_bound if ind >= size
+   */
+  template <class I, IfIndex<I> = 0>
+  constexpr iterator erase(I i) {
+    size_t ind = i;
+    if (ind >= cur_size) throw index_out_of_bound();
+    ShiftLeft(ind, 1);
+    return Data() + ind;
+  }
+  /**
+   * removes the elements in [first, last).
+   * throw invalid_iterator if [first, last) is not a valid range of this.
+   */
+  constexpr iterator erase(const_iterator first, const_iterator last) {
+    size_t l = Index(first), r = Index(last);
+    if (l > r) throw invalid_iterator();
+    if (l < r) ShiftLeft(l, r - l);
+    return Data() + l;
+  }
+
+  /**
+   * adds an element to the end.
+   * throw capacity_exceeded if the vector is full
+   */
+  constexpr void push_back(const T &value) { emplace_back(value); }
+  constexpr void push_back(T &&value) { emplace_back(std::move(value)); }
+  template <class... Args>
+  constexpr T &emplace_back(Args &&...args) {
+    if (cur_size == N) throw capacity_exceeded();
+    Construct(cur_size, std::forward<Args>(args)...);
+    return Data()[cur_size++];
+  }
+  /**
+   * remove the last element from the end.
+   * throw container_is_empty if size() == 0
+   */
+  constexpr void pop_back() {
+    if (!cur_size) throw container_is_empty();
+    Destroy(--cur_size);
+  }
+};
+
+}  // namespace sjtu
+
+#endif
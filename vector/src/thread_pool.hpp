@@ -0,0 +1,192 @@
+#ifndef SJTU_THREAD_POOL_HPP
+#define SJTU_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a work-stealing thread pool.
+ * every worker owns a deque: tasks spawned by a worker go to the back of its
+ * own deque and are taken from the back (most recent first, cache friendly),
+ * idle workers steal from the front of the others. tasks submitted by
+ * threads outside the pool are spread over the deques round robin.
+ *
+ * a pool with 0 workers is valid: task_group::wait() then runs every task
+ * on the waiting thread.
+ */
+class thread_pool {
+  friend class task_group;
+
+  struct Queue {
+    std::mutex m;
+    std::deque<std::function<void()>> tasks;
+  };
+  struct Local {
+    thread_pool *pool;
+    size_t index;
+  };
+
+  size_t n;  // 工作线程数。
+  std::unique_ptr<Queue[]> queues;  // 至少一个，供无工作线程时使用。
+  vector<std::thread> workers;
+  std::atomic<long long> pending{0};  // 队列中尚未取走的任务数。
+  std::atomic<size_t> next{0};
+  std::mutex sleep_m;
+  std::condition_variable sleep_cv;
+  bool stop = false;
+
+  static Local &Current() {
+    static thread_local Local cur{nullptr, 0};
+    return cur;
+  }
+  size_t Queues() const { return n ? n : 1; }
+
+  void Submit(std::function<void()> task) {
+    Local &cur = Current();
+    size_t i = cur.pool == this ? cur.index : next++ % Queues();
+    {
+      std::lock_guard<std::mutex> lk(queues[i].m);
+      queues[i].tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lk(sleep_m);
+      ++pending;
+    }
+    sleep_cv.notify_one();
+  }
+  // 取出并执行一个任务：先取自己队列的末尾，再从其它队列的开头窃取。
+  bool TryRun() {
+    Local &cur = Current();
+    size_t self = cur.pool == this ? cur.index : 0, q = Queues();
+    std::function<void()> task;
+    for (size_t k = 0; k < q && !task; ++k) {
+      Queue &queue = queues[(self + k) % q];
+      std::lock_guard<std::mutex> lk(queue.m);
+      if (queue.tasks.empty()) continue;
+      if (k == 0 && cur.pool == this) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+    }
+    if (!task) return false;
+    --pending;
+    task();
+    return true;
+  }
+  void Work(size_t index) {
+    Current() = Local{this, index};
+    while (true) {
+      if (TryRun()) continue;
+      std::unique_lock<std::mutex> lk(sleep_m);
+      sleep_cv.wait(lk, [this] { return stop || pending > 0; });
+      if (stop && pending <= 0) return;
+    }
+  }
+
+ public:
+  /**
+   * starts threads workers. the thread calling task_group::wait() helps
+   * too, so threads = hardware_concurrency() - 1 keeps every core busy.
+   */
+  explicit thread_pool(size_t threads)
+      : n(threads), queues(new Queue[Queues()]) {
+    for (size_t i = 0; i < n; ++i)
+      workers.push_back(std::thread(&thread_pool::Work, this, i));
+  }
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  /**
+   * finishes the queued tasks, then joins the workers.
+   */
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lk(sleep_m);
+      stop = true;
+    }
+    sleep_cv.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+  }
+
+  /**
+   * the number of worker threads.
+   */
+  size_t size() const { return n; }
+  /**
+   * the number of threads that can run tasks at once, the waiting thread
+   * included.
+   */
+  size_t concurrency() const { return n + 1; }
+};
+
+/**
+ * the pool shared by the whole program, with one thread per core (the
+ * waiting thread being one of them). it is created on first use.
+ */
+inline thread_pool &default_pool() {
+  static thread_pool pool([] {
+    size_t hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 0;
+  }());
+  return pool;
+}
+
+/**
+ * a set of tasks run on a pool and waited for together (fork-join).
+ * wait() runs queued tasks while it waits, so tasks may themselves create
+ * task groups and wait on them without deadlocking the pool.
+ * the first exception thrown by a task is rethrown by wait().
+ */
+class task_group {
+  thread_pool &pool;
+  std::atomic<size_t> remaining{0};
+  std::mutex m;
+  std::exception_ptr error;
+
+  void Wait() {
+    while (remaining)
+      if (!pool.TryRun()) std::this_thread::yield();
+  }
+
+ public:
+  explicit task_group(thread_pool &pool = default_pool()) : pool(pool) {}
+  task_group(const task_group &) = delete;
+  task_group &operator=(const task_group &) = delete;
+  ~task_group() { Wait(); }
+
+  template <class F>
+  void run(F &&f) {
+    ++remaining;
+    pool.Submit([this, f = std::forward<F>(f)]() mutable {
+      try {
+        f();
+      } catch (...) {
+        std::lock_guard<std::mutex> lk(m);
+        if (!error) error = std::current_exception();
+      }
+      --remaining;
+    });
+  }
+  void wait() {
+    Wait();
+    if (error) std::rethrow_exception(std::exchange(error, nullptr));
+  }
+  thread_pool &get_pool() const { return pool; }
+};
+
+}  // namespace sjtu
+
+#endif
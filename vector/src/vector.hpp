@@ -1,30 +1,386 @@
 #ifndef SJTU_VECTOR_HPP
 #define SJTU_VECTOR_HPP
 
+#include <algorithm>
 #include <climits>
 #include <cmath>  // 允许使用的头文件
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "exceptions.hpp"
+#ifdef SJTU_VECTOR_STATS
+#include "vector_stats.hpp"
+#endif
 
 namespace sjtu {
+/**
+ * whether an object of type T can be moved to another address by a plain
+ * memory copy, after which the old bytes are simply dropped (no destructor).
+ * true for trivially copyable types; specialize it to opt in other types,
+ * e.g. ones owning heap memory but never pointing into themselves.
+ */
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/**
+ * growth policies of vector.
+ * next(limit, need, size) returns the new capacity (at least need) for a
+ * vector of capacity limit whose elements are size bytes each.
+ */
+template <size_t Num, size_t Den>
+struct ratio_growth {
+  static size_t next(size_t limit, size_t need, size_t) {
+    size_t grown = limit * Num / Den;
+    if (grown <= limit) grown = limit + 1;
+    return grown < need ? need : grown;
+  }
+};
+using double_growth = ratio_growth<2, 1>;
+// 内存更省，释放的旧空间更容易被之后的扩容复用。
+using three_halves_growth = ratio_growth<3, 2>;
+/**
+ * grows like double_growth, then rounds the buffer up to the size classes of
+ * common malloc implementations (powers of two up to a page, whole pages
+ * beyond) so that the slack malloc hands out anyway becomes capacity.
+ */
+struct size_class_growth {
+  static constexpr size_t page = 4096;
+  static size_t next(size_t limit, size_t need, size_t size) {
+    size_t bytes = double_growth::next(limit, need, size) * size;
+    if (bytes <= page) {
+      size_t c = 16;
+      while (c < bytes) c <<= 1;
+      bytes = c;
+    } else {
+      bytes = (bytes + page - 1) / page * page;
+    }
+    return bytes / size;
+  }
+};
+
+/**
+ * the default allocator of vector, a std-compatible allocator on top of
+ * malloc/free. reallocate() lets vector grow trivially relocatable elements
+ * with realloc.
+ */
+template <typename T>
+class allocator {
+ public:
+  using value_type = T;
+
+  allocator() = default;
+  template <typename U>
+  allocator(const allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    T *p = (T *)malloc(n * sizeof(T));
+    if (!p) throw runtime_error();
+    return p;
+  }
+  void deallocate(T *p, size_t) { free(p); }
+  // 调整 p 的大小，原有内容按字节保留。
+  T *reallocate(T *p, size_t, size_t n) {
+    T *tmp = (T *)realloc((void *)p, n * sizeof(T));
+    if (!tmp) throw runtime_error();
+    return tmp;
+  }
+
+  template <typename U>
+  bool operator==(const allocator<U> &) const { return true; }
+  template <typename U>
+  bool operator!=(const allocator<U> &) const { return false; }
+};
+
 /**
  * a data container like std::vector
  * store data in a successive memory and support random access.
+ * Allocator is a std-compatible allocator providing the storage;
+ * Growth decides the new capacity whenever the vector runs out of space.
  */
-template <typename T>
+template <typename T, class Allocator = allocator<T>,
+          class Growth = double_growth>
 class vector {
+  using Traits = std::allocator_traits<Allocator>;
+  static_assert(std::is_same<typename Traits::pointer, T *>::value,
+                "vector does not support fancy pointers");
+
   T *array;
   size_t cur_size = 0, limit;  // 当前元素个数与当前申请的空间大小。
+  Allocator alloc;
+#ifdef SJTU_VECTOR_STATS
+  vector_stats counters;  // 本 vector 的计数，同类型的合计见 type_stats.
+#endif
+
+  // 统计钩子，未定义 SJTU_VECTOR_STATS 时都是空函数。
+  void NoteAllocate([[maybe_unused]] size_t n) {
+#ifdef SJTU_VECTOR_STATS
+    if (n * sizeof(T) > counters.peak_capacity)
+      counters.peak_capacity = n * sizeof(T);
+    type_stats::of<T>().allocated(n * sizeof(T));
+#endif
+  }
+  void NoteDeallocate([[maybe_unused]] size_t n) {
+#ifdef SJTU_VECTOR_STATS
+    type_stats::of<T>().deallocated(n * sizeof(T));
+#endif
+  }
+  // 换缓冲区时搬动了 moved 个元素。
+  void NoteReallocate([[maybe_unused]] size_t moved) {
+#ifdef SJTU_VECTOR_STATS
+    ++counters.reallocations, counters.bytes_moved += moved * sizeof(T);
+    ++type_stats::of<T>().reallocations;
+    type_stats::of<T>().bytes_moved += moved * sizeof(T);
+#endif
+  }
+  // n 个元素从 other 转到了本 vector（接管缓冲区或直接搬动内存），它们的
+  // 构造也记到本 vector 名下，使每个 vector 的构造数减析构数等于 size().
+  void NoteAdopt([[maybe_unused]] vector &other, [[maybe_unused]] size_t n) {
+#ifdef SJTU_VECTOR_STATS
+    counters.constructions += n, other.counters.constructions -= n;
+#endif
+  }
+
+  T *Allocate(size_t n) {
+    if (!n) return nullptr;
+    T *p = Traits::allocate(alloc, n);
+    NoteAllocate(n);
+    return p;
+  }
+  void Deallocate(T *p, size_t n) {
+    if (p) Traits::deallocate(alloc, p, n), NoteDeallocate(n);
+  }
+  template <class... Args>
+  void Construct(T *p, Args &&...args) {
+    Traits::construct(alloc, p, std::forward<Args>(args)...);
+#ifdef SJTU_VECTOR_STATS
+    ++counters.constructions, ++type_stats::of<T>().constructions;
+#endif
+  }
+  void Destroy(T *p) {
+    Traits::destroy(alloc, p);
+#ifdef SJTU_VECTOR_STATS
+    ++counters.destructions, ++type_stats::of<T>().destructions;
+#endif
+  }
+
+  // 分配器是否提供 reallocate(p, old_n, n)（例如 sjtu::allocator）。
+  template <class A, class = void>
+  struct CanReallocate : std::false_type {};
+  template <class A>
+  struct CanReallocate<A, std::void_t<decltype(std::declval<A &>().reallocate(
+                              std::declval<T *>(), size_t(), size_t()))>>
+      : std::true_type {};
+
+  // 搬动元素时能否边构造边析构原对象：移动构造会抛异常的类型只能拷贝，
+  // 要等全部拷贝成功后才能析构原对象。
+  static constexpr bool nothrow_relocate =
+      is_trivially_relocatable<T>::value ||
+      std::is_nothrow_move_constructible<T>::value;
+  // 在未初始化的 dst 上构造 [src, src + n) 的副本；中途抛出异常时析构已构造
+  // 的部分再抛出，src 不受影响。
+  void CopyTo(T *dst, const T *src, size_t n) {
+    size_t i = 0;
+    try {
+      for (; i < n; ++i) Construct(dst + i, src[i]);
+    } catch (...) {
+      while (i) Destroy(dst + --i);
+      throw;
+    }
+  }
+  // 把 [src, src + n) 搬到未初始化的 dst 上，原位置上的对象随之结束生命。
+  // 拷贝抛出异常时 src 保持不变。
+  void Relocate(T *dst, T *src, size_t n) {
+    if constexpr (is_trivially_relocatable<T>::value) {
+      if (n) memcpy((void *)dst, (const void *)src, n * sizeof(T));
+    } else if constexpr (nothrow_relocate) {
+      for (size_t i = 0; i < n; ++i) {
+        Construct(dst + i, std::move(src[i]));
+        Destroy(src + i);
+      }
+    } else {
+      CopyTo(dst, src, n);
+      for (size_t i = 0; i < n; ++i) Destroy(src + i);
+    }
+  }
+  // 把空间调整为 new_limit（需不小于 cur_size）。
+  void Reallocate(size_t new_limit) {
+    if (!new_limit) {
+      Deallocate(array, limit);
+      array = nullptr, limit = 0;
+      return;
+    }
+    T *tmp;
+    if (array) NoteReallocate(cur_size);
+    if constexpr (is_trivially_relocatable<T>::value &&
+                  CanReallocate<Allocator>::value) {
+      // 交给 realloc，可能原地扩张；大块内存上 glibc 会直接 mremap 而不拷贝。
+      if (array) {
+        tmp = alloc.reallocate(array, limit, new_limit);
+        NoteDeallocate(limit), NoteAllocate(new_limit);
+      } else {
+        tmp = Allocate(new_limit);
+      }
+    } else {
+      tmp = Allocate(new_limit);
+      try {
+        Relocate(tmp, array, cur_size);
+      } catch (...) {
+        Deallocate(tmp, new_limit);
+        throw;
+      }
+      Deallocate(array, limit);
+    }
+    limit = new_limit, array = tmp;
+  }
+  // 空间不足以容纳 need 个元素时按增长策略扩容。
+  void Expand(size_t need) {
+    if (need > limit) Reallocate(Growth::next(limit, need, sizeof(T)));
+  }
+  // 在末尾追加 n 个默认初始化的元素并返回其起点；平凡类型不做任何初始化。
+  T *AppendDefault(size_t n) {
+    Expand(cur_size + n);
+    T *p = array + cur_size;
+    if constexpr (std::is_trivially_default_constructible<T>::value) {
+      cur_size += n;
+#ifdef SJTU_VECTOR_STATS
+      counters.constructions += n, type_stats::of<T>().constructions += n;
+#endif
+    } else {
+      for (; n; --n) Construct(array + cur_size++);
+    }
+    return p;
+  }
+  // 在 ind 处腾出 n 个未初始化的位置并返回其起点（不改变 cur_size）。
+  // 空间不足时只扩容一次，原有元素也只搬动一次。
+  T *OpenGap(size_t ind, size_t n) {
+    if (!n) return array + ind;
+    if (cur_size + n > limit) {
+      size_t new_limit = Growth::next(limit, cur_size + n, sizeof(T));
+      if (ind == cur_size) return Reallocate(new_limit), array + ind;
+      if (array) NoteReallocate(cur_size);
+      T *tmp = Allocate(new_limit);
+      if constexpr (nothrow_relocate) {
+        Relocate(tmp, array, ind);
+        Relocate(tmp + ind + n, array + ind, cur_size - ind);
+      } else {
+        // 两段都拷贝成功后才析构原对象，失败时 *this 不变。
+        try {
+          CopyTo(tmp, array, ind);
+          try {
+            CopyTo(tmp + ind + n, array + ind, cur_size - ind);
+          } catch (...) {
+            for (size_t i = 0; i < ind; ++i) Destroy(tmp + i);
+            throw;
+          }
+        } catch (...) {
+          Deallocate(tmp, new_limit);
+          throw;
+        }
+        for (size_t i = 0; i < cur_size; ++i) Destroy(array + i);
+      }
+      Deallocate(array, limit);
+      limit = new_limit, array = tmp;
+    } else if constexpr (is_trivially_relocatable<T>::value) {
+      memmove((void *)(array + ind + n), (const void *)(array + ind),
+              (cur_size - ind) * sizeof(T));
+    } else {
+      for (size_t i = cur_size; i-- > ind;) {
+        Construct(array + i + n, std::move(array[i]));
+        Destroy(array + i);
+      }
+    }
+    return array + ind;
+  }
+  // OpenGap(ind, n) 之后构造新元素时抛出了异常：析构已构造的前 built 个，
+  // 再把后面的元素挪回 ind 处，恢复插入之前的内容（cur_size 仍未改变）。
+  void CloseGap(size_t ind, size_t n, size_t built) {
+    for (size_t i = 0; i < built; ++i) Destroy(array + ind + i);
+    if constexpr (is_trivially_relocatable<T>::value) {
+      memmove((void *)(array + ind), (const void *)(array + ind + n),
+              (cur_size - ind) * sizeof(T));
+    } else {
+      for (size_t i = ind; i < cur_size; ++i) {
+        Construct(array + i, std::move(array[i + n]));
+        Destroy(array + i + n);
+      }
+    }
+  }
+
+  // 接管 other 的空间，需保证自己当前没有空间。
+  void Steal(vector &other) {
+    NoteAdopt(other, other.cur_size);
+    array = other.array, cur_size = other.cur_size, limit = other.limit;
+    other.array = nullptr, other.cur_size = other.limit = 0;
+  }
+  // 把 other 的元素逐个搬到自己的空间上，需保证自己当前为空。
+  void MoveFrom(vector &other) {
+    reserve(other.cur_size);
+    Relocate(array, other.array, other.cur_size);
+    NoteAdopt(other, other.cur_size);
+    cur_size = other.cur_size, other.cur_size = 0;
+  }
+
+  template <class It>
+  using Category = typename std::iterator_traits<It>::iterator_category;
+  // 仅用于区分 insert(pos, count, value) 与 insert(pos, first, last).
+  template <class It>
+  using RequireIterator = std::enable_if_t<!std::is_integral<It>::value>;
+
+  template <class It>
+  static size_t Distance(It first, It last) {
+    if constexpr (std::is_base_of<std::random_access_iterator_tag,
+                                  Category<It>>::value) {
+      return last - first;
+    } else {
+      size_t n = 0;
+      for (; first != last; ++first) ++n;
+      return n;
+    }
+  }
 
-  void DoubleSpace() {
-    T *tmp = (T *)malloc((limit << 1) * sizeof(T));
-    for (int i = 0; i < cur_size; ++i) {
-      new (tmp + i) T(array[i]);
-      array[i].~T();
+  // [ind, cur_size) 整体后移一位，之后 ind 处为未初始化的空间（不改变 cur_size）。
+  // 需保证 ind < cur_size < limit.
+  void ShiftRight(size_t ind) {
+    if constexpr (is_trivially_relocatable<T>::value) {
+      memmove((void *)(array + ind + 1), (const void *)(array + ind),
+              (cur_size - ind) * sizeof(T));
+    } else {
+      Construct(array + cur_size, std::move(array[cur_size - 1]));
+      std::move_backward(array + ind, array + cur_size - 1, array + cur_size);
+      Destroy(array + ind);
     }
-    free(array);
-    limit <<= 1, array = tmp;
+  }
+  // 删除 [ind, ind + n) 的元素，之后的元素整体前移 n 位。
+  void ShiftLeft(size_t ind, size_t n = 1) {
+    if constexpr (is_trivially_relocatable<T>::value) {
+      for (size_t i = ind; i < ind + n; ++i) Destroy(array + i);
+      if (ind + n < cur_size)  // array 可能为空指针，不能交给 memmove。
+        memmove((void *)(array + ind), (const void *)(array + ind + n),
+                (cur_size - ind - n) * sizeof(T));
+    } else {
+      std::move(array + ind + n, array + cur_size, array + ind);
+      for (size_t i = cur_size - n; i < cur_size; ++i) Destroy(array + i);
+    }
+    cur_size -= n;
+  }
+
+ public:
+  class const_iterator;
+
+ private:
+  // 迭代器对应的下标，迭代器不在 [begin(), end()] 内时抛出 invalid_iterator.
+  size_t Index(const const_iterator &pos) const {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+    if (pos.source != this) throw invalid_iterator();
+#endif
+    if (pos.ptr < array || pos.ptr > array + cur_size) throw invalid_iterator();
+    return pos.ptr - array;
   }
 
  public:
@@ -36,7 +392,6 @@ class vector {
   /**
    * you can see RandomAccessIterator at CppReference for help.
    */
-  class const_iterator;
   class iterator {
     // The following code is written for the C++ type_traits library.
     // Type traits is a C++ feature for describing certain properties of a type.
@@ -52,177 +407,292 @@ class vector {
     // https://blog.csdn.net/u014299153/article/details/72419713 About
     // iterator_category: https://en.cppreference.com/w/cpp/iterator
     friend class vector;
+    friend class const_iterator;
 
    public:
     using difference_type = std::ptrdiff_t;
     using value_type = T;
     using pointer = T *;
     using reference = T &;
-    using iterator_category = std::output_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
 
    private:
-    int at;
-    vector *source;
+    // 直接保存元素地址，解引用不再经过 source->array.
+    // 定义 SJTU_VECTOR_CHECKED_ITERATOR 时额外记录所属的 vector 以便检查。
+    T *ptr{nullptr};
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+    const vector *source{nullptr};
+#endif
+
+    iterator(T *ptr, [[maybe_unused]] const vector *source) : ptr(ptr) {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+      this->source = source;
+#endif
+    }
+    void Check([[maybe_unused]] const const_iterator &rhs) const {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+      if (source != rhs.source) throw invalid_iterator();
+#endif
+    }
 
    public:
     /**
      * return a new iterator which pointer n-next elements
      * as well as operator-
      */
-    iterator() {}
-    iterator(int i, vector *source) : at(i), source(source) {}
+    iterator() = default;
 
-    iterator operator+(const int &n) const {
+    iterator operator+(const difference_type &n) const {
       iterator ret = *this;
-      ret.at += n;
+      ret.ptr += n;
       return ret;
     }
-    iterator operator-(const int &n) const {
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
       iterator ret = *this;
-      ret.at -= n;
+      ret.ptr -= n;
       return ret;
     }
     // return the distance between two iterators,
     // if these two iterators point to different vectors, throw
-    // invaild_iterator.
-    int operator-(const iterator &rhs) const {
-      if (source != rhs.source) throw invalid_iterator();
-      return abs(rhs.at - at);
+    // invaild_iterator (only checked with SJTU_VECTOR_CHECKED_ITERATOR).
+    difference_type operator-(const const_iterator &rhs) const {
+      Check(rhs);
+      return ptr - rhs.ptr;
     }
-    iterator &operator+=(const int &n) { return *this = *this + n; }
-    iterator &operator-=(const int &n) { return *this = *this - n; }
+    iterator &operator+=(const difference_type &n) { return ptr += n, *this; }
+    iterator &operator-=(const difference_type &n) { return ptr -= n, *this; }
 
     iterator operator++(int) {
-      iterator ret = *this + 1;
-      *this += 1;
+      iterator ret = *this;
+      ++ptr;
       return ret;
     }
-    iterator &operator++() { return *this += 1; }
+    iterator &operator++() { return ++ptr, *this; }
 
     iterator operator--(int) {
-      iterator ret = *this + 1;
-      *this -= 1;
+      iterator ret = *this;
+      --ptr;
       return ret;
     }
-    iterator &operator--() { return *this -= 1; }
+    iterator &operator--() { return --ptr, *this; }
 
-    T &operator*() const { return source->array[at]; }
+    T &operator*() const {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+      if (!source || ptr < source->array ||
+          ptr >= source->array + source->cur_size)
+        throw invalid_iterator();
+#endif
+      return *ptr;
+    }
+    T *operator->() const { return ptr; }
+    T &operator[](const difference_type &n) const { return *(*this + n); }
     /**
      * a operator to check whether two iterators are same (pointing to the same
      * memory address).
      */
-    bool operator==(const iterator &rhs) const {
-      return source == rhs.source && at == rhs.at;
-    }
-    bool operator==(const const_iterator &rhs) const {
-      return source == rhs.source && at == rhs.at;
-    }
+    bool operator==(const iterator &rhs) const { return ptr == rhs.ptr; }
+    bool operator==(const const_iterator &rhs) const { return ptr == rhs.ptr; }
     /**
      * some other operator for iterator.
      */
-    bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
-    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator!=(const iterator &rhs) const { return ptr != rhs.ptr; }
+    bool operator!=(const const_iterator &rhs) const { return ptr != rhs.ptr; }
+    bool operator<(const iterator &rhs) const { return ptr < rhs.ptr; }
+    bool operator<(const const_iterator &rhs) const { return ptr < rhs.ptr; }
+    bool operator>(const iterator &rhs) const { return ptr > rhs.ptr; }
+    bool operator>(const const_iterator &rhs) const { return ptr > rhs.ptr; }
+    bool operator<=(const iterator &rhs) const { return ptr <= rhs.ptr; }
+    bool operator<=(const const_iterator &rhs) const { return ptr <= rhs.ptr; }
+    bool operator>=(const iterator &rhs) const { return ptr >= rhs.ptr; }
+    bool operator>=(const const_iterator &rhs) const { return ptr >= rhs.ptr; }
   };
   /**
-   * TODO
    * has same function as iterator, just for a const object.
    */
   class const_iterator {
     friend class vector;
+    friend class iterator;
 
    public:
     using difference_type = std::ptrdiff_t;
     using value_type = T;
-    using pointer = T *;
-    using reference = T &;
-    using iterator_category = std::output_iterator_tag;
+    using pointer = const T *;
+    using reference = const T &;
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
 
-   private:  // TODO : 临时解决办法。
-    int at;
-    const vector *source;
+   private:
+    const T *ptr{nullptr};
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+    const vector *source{nullptr};
+#endif
+
+    const_iterator(const T *ptr, [[maybe_unused]] const vector *source)
+        : ptr(ptr) {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+      this->source = source;
+#endif
+    }
+    void Check([[maybe_unused]] const const_iterator &rhs) const {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+      if (source != rhs.source) throw invalid_iterator();
+#endif
+    }
 
    public:
-    const_iterator() {}
-    const_iterator(int i, const vector *source) : at(i), source(source) {}
+    const_iterator() = default;
+    const_iterator(const iterator &other) : ptr(other.ptr) {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+      source = other.source;
+#endif
+    }
 
-    const_iterator operator+(const int &n) const {
+    const_iterator operator+(const difference_type &n) const {
       const_iterator ret = *this;
-      ret.at += n;
+      ret.ptr += n;
       return ret;
     }
-    const_iterator operator-(const int &n) const {
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
       const_iterator ret = *this;
-      ret.at -= n;
+      ret.ptr -= n;
       return ret;
     }
     // return the distance between two iterators,
     // if these two iterators point to different vectors, throw
-    // invaild_iterator.
-    int operator-(const const_iterator &rhs) const {
-      if (source != rhs.source) throw invalid_iterator();
-      return abs(rhs.at - at);
+    // invaild_iterator (only checked with SJTU_VECTOR_CHECKED_ITERATOR).
+    difference_type operator-(const const_iterator &rhs) const {
+      Check(rhs);
+      return ptr - rhs.ptr;
+    }
+    const_iterator &operator+=(const difference_type &n) {
+      return ptr += n, *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      return ptr -= n, *this;
     }
-    const_iterator &operator+=(const int &n) { return *this = *this + n; }
-    const_iterator &operator-=(const int &n) { return *this = *this - n; }
 
     const_iterator operator++(int) {
-      const_iterator ret = *this + 1;
-      *this += 1;
+      const_iterator ret = *this;
+      ++ptr;
       return ret;
     }
-    const_iterator &operator++() { return *this += 1; }
+    const_iterator &operator++() { return ++ptr, *this; }
 
     const_iterator operator--(int) {
-      const_iterator ret = *this + 1;
-      *this -= 1;
+      const_iterator ret = *this;
+      --ptr;
       return ret;
     }
-    const_iterator &operator--() { return *this -= 1; }
+    const_iterator &operator--() { return --ptr, *this; }
 
-    const T operator*() const { return source->array[at]; }
+    const T &operator*() const {
+#ifdef SJTU_VECTOR_CHECKED_ITERATOR
+      if (!source || ptr < source->array ||
+          ptr >= source->array + source->cur_size)
+        throw invalid_iterator();
+#endif
+      return *ptr;
+    }
+    const T *operator->() const { return ptr; }
+    const T &operator[](const difference_type &n) const {
+      return *(*this + n);
+    }
     /**
      * a operator to check whether two iterators are same (pointing to the same
      * memory address).
      */
-    bool operator==(const iterator &rhs) const {
-      return source == rhs.source && at == rhs.at;
-    }
-    bool operator==(const const_iterator &rhs) const {
-      return source == rhs.source && at == rhs.at;
-    }
+    bool operator==(const const_iterator &rhs) const { return ptr == rhs.ptr; }
     /**
      * some other operator for iterator.
      */
-    bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
-    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator!=(const const_iterator &rhs) const { return ptr != rhs.ptr; }
+    bool operator<(const const_iterator &rhs) const { return ptr < rhs.ptr; }
+    bool operator>(const const_iterator &rhs) const { return ptr > rhs.ptr; }
+    bool operator<=(const const_iterator &rhs) const { return ptr <= rhs.ptr; }
+    bool operator>=(const const_iterator &rhs) const { return ptr >= rhs.ptr; }
   };
 
-  vector(int cnt = 9) : limit(cnt) {
-    array = (T *)malloc(limit * sizeof(T));  // 注意区别申请大小与实际大小。
+  // cnt 为初始申请的空间大小，默认不申请空间，直到第一次插入。
+  vector(int cnt = 0, const Allocator &alloc = Allocator())
+      : limit(cnt), alloc(alloc) {
+    array = Allocate(limit);  // 注意区别申请大小与实际大小。
+  }
+  explicit vector(const Allocator &alloc) : vector(0, alloc) {}
+  vector(const vector &other)
+      : cur_size(other.cur_size),
+        limit(cur_size),
+        alloc(Traits::select_on_container_copy_construction(other.alloc)) {
+    array = Allocate(limit);
+    for (size_t i = 0; i < cur_size; ++i) Construct(array + i, other.array[i]);
   }
-  vector(const vector &other) : cur_size(other.cur_size) {
-    limit = cur_size + 9;
-    array = (T *)malloc(limit * sizeof(T));
-    for (int i = 0; i < cur_size; ++i) new (array + i) T(other[i]);
+  // 分配器相等时直接接管 other 的空间，否则只能逐个移动到自己的空间上。
+  // 之后 other 变为空的 vector.
+  vector(vector &&other) noexcept(Traits::is_always_equal::value)
+      : array(nullptr), limit(0), alloc(std::move(other.alloc)) {
+    if (Traits::is_always_equal::value || alloc == other.alloc)
+      Steal(other);
+    else
+      MoveFrom(other);
   }
   ~vector() {
-    if (array) {
-      for (int i = 0; i < cur_size; ++i) array[i].~T();
-      free(array);  // 注意区别申请大小与实际大小。
-    }
+    clear();
+    Deallocate(array, limit);  // 注意区别申请大小与实际大小。
   }
 
   vector &operator=(const vector &other) {
     if (&other != this) {
-      for (int i = 0; i < cur_size; ++i) array[i].~T();
-      free(array);
-      cur_size = other.cur_size, limit = cur_size + 9;
-      array = (T *)malloc(limit * sizeof(T));
-      for (int i = 0; i < cur_size; ++i) new (array + i) T(other[i]);
+      if constexpr (Traits::propagate_on_container_copy_assignment::value) {
+        // 旧空间只能交还给原来的分配器。
+        if (alloc != other.alloc) clear(), Reallocate(0);
+        alloc = other.alloc;
+      }
+      clear(), reserve(other.cur_size);  // 空间足够时直接复用。
+      for (size_t i = 0; i < other.cur_size; ++i)
+        Construct(array + i, other.array[i]);
+      cur_size = other.cur_size;
+    }
+    return *this;
+  }
+  vector &operator=(vector &&other) noexcept(
+      Traits::propagate_on_container_move_assignment::value ||
+      Traits::is_always_equal::value) {
+    if (&other != this) {
+      clear();
+      if constexpr (Traits::propagate_on_container_move_assignment::value) {
+        Reallocate(0), alloc = std::move(other.alloc), Steal(other);
+      } else if (Traits::is_always_equal::value || alloc == other.alloc) {
+        Reallocate(0), Steal(other);
+      } else {
+        MoveFrom(other);
+      }
     }
     return *this;
   }
 
+  Allocator get_allocator() const { return alloc; }
+#ifdef SJTU_VECTOR_STATS
+  /**
+   * the counters of this vector; slack is the unused capacity in bytes.
+   */
+  vector_stats stats() const {
+    vector_stats s = counters;
+    s.slack = (limit - cur_size) * sizeof(T);
+    return s;
+  }
+#endif
+
   T &at(const size_t &pos) {
     if (pos < 0 || pos >= cur_size) throw index_out_of_bound();
     return array[pos];
@@ -247,30 +717,89 @@ class vector {
   /**
    * returns an iterator to the beginning.
    */
-  iterator begin() { return iterator(0, this); }
-  const_iterator cbegin() const { return const_iterator(0, this); }
+  iterator begin() { return iterator(array, this); }
+  const_iterator begin() const { return const_iterator(array, this); }
+  const_iterator cbegin() const { return const_iterator(array, this); }
   /**
    * returns an iterator to the end.
    */
-  iterator end() { return iterator(cur_size, this); }
-  const_iterator cend() const { return const_iterator(cur_size, this); }
+  iterator end() { return iterator(array + cur_size, this); }
+  const_iterator end() const { return const_iterator(array + cur_size, this); }
+  const_iterator cend() const {
+    return const_iterator(array + cur_size, this);
+  }
+
+  /**
+   * returns a pointer to the underlying storage.
+   */
+  T *data() { return array; }
+  const T *data() const { return array; }
 
   bool empty() const { return !cur_size; }
 
   size_t size() const { return cur_size; }
   /**
-   * clears the contents
+   * returns the number of elements that can be held without reallocation.
+   */
+  size_t capacity() const { return limit; }
+  /**
+   * makes the capacity at least n, reallocating exactly once if needed.
+   */
+  void reserve(const size_t &n) {
+    if (n > limit) Reallocate(n);
+  }
+  /**
+   * releases the unused capacity.
+   */
+  void shrink_to_fit() {
+    if (limit > cur_size) Reallocate(cur_size);
+  }
+  /**
+   * resizes the container to contain n elements, appending value-initialized
+   * elements (or copies of value) if it grows.
+   */
+  void resize(const size_t &n) {
+    if (n <= cur_size) return ShiftLeft(n, cur_size - n);
+    Expand(n);
+    for (; cur_size < n; ++cur_size) Construct(array + cur_size);
+  }
+  void resize(const size_t &n, const T &value) {
+    if (n <= cur_size) return ShiftLeft(n, cur_size - n);
+    T tmp(value);  // value 可能就是本 vector 中的元素，先复制一份。
+    Expand(n);
+    for (; cur_size < n; ++cur_size) Construct(array + cur_size, tmp);
+  }
+  /**
+   * like resize(n), but the appended elements are default-initialized:
+   * trivially default constructible ones (char, float, ...) keep whatever
+   * bytes the storage held, so a buffer about to be overwritten is not
+   * zeroed first.
+   */
+  void resize_default_init(const size_t &n) {
+    if (n <= cur_size) return ShiftLeft(n, cur_size - n);
+    AppendDefault(n - cur_size);
+  }
+  /**
+   * appends n elements default-initialized as by resize_default_init() and
+   * returns a pointer to the first of them, so data can be received in
+   * place: read(fd, v.append_uninitialized(n), n * sizeof(T)), then
+   * resize() down to what was actually read.
+   * the pointer is invalidated like an iterator.
    */
-  void clear() { cur_size = 0; }
+  T *append_uninitialized(const size_t &n) { return AppendDefault(n); }
+  /**
+   * clears the contents, keeping the capacity.
+   */
+  void clear() {
+    for (size_t i = 0; i < cur_size; ++i) Destroy(array + i);
+    cur_size = 0;
+  }
   /**
    * inserts value before pos
    * returns an iterator pointing to the inserted value.
    */
   iterator insert(iterator pos, const T &value) {
-    if (cur_size + 1 == limit) DoubleSpace();
-    for (int i = cur_size; i > pos.at; --i) array[i] = array[i - 1];
-    array[pos.at] = value, ++cur_size;
-    return pos;
+    return insert(Index(pos), value);
   }
   /**
    * inserts value at index ind.
@@ -280,11 +809,109 @@ class vector {
    * because after inserting the size will increase 1.)
    */
   iterator insert(const size_t &ind, const T &value) {
+    return emplace(ind, value);
+  }
+  iterator insert(iterator pos, T &&value) {
+    return emplace(Index(pos), std::move(value));
+  }
+  iterator insert(const size_t &ind, T &&value) {
+    return emplace(ind, std::move(value));
+  }
+  /**
+   * constructs an element in place from args before pos.
+   * returns an iterator pointing to the new element.
+   * throw index_out_of_bound if ind > size.
+   */
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args &&...args) {
+    return emplace(Index(pos), std::forward<Args>(args)...);
+  }
+  template <class... Args>
+  iterator emplace(const size_t &ind, Args &&...args) {
+    if (ind > cur_size) throw index_out_of_bound();
+    if (ind == cur_size) {
+      emplace_back(std::forward<Args>(args)...);
+    } else {
+      // 参数可能引用本 vector 中的元素，先构造出来再挪动其它元素。
+      T tmp(std::forward<Args>(args)...);
+      Expand(cur_size + 1);
+      ShiftRight(ind);
+      Construct(array + ind, std::move(tmp)), ++cur_size;
+    }
+    return iterator(array + ind, this);
+  }
+  /**
+   * inserts count copies of value before pos.
+   * returns an iterator pointing to the first inserted element (or pos if
+   * count == 0).
+   */
+  iterator insert(iterator pos, const size_t &count, const T &value) {
+    return insert(Index(pos), count, value);
+  }
+  iterator insert(const size_t &ind, const size_t &count, const T &value) {
+    if (ind > cur_size) throw index_out_of_bound();
+    if (!count) return iterator(array + ind, this);
+    T tmp(value);  // value 可能就是本 vector 中的元素，先复制一份。
+    T *p = OpenGap(ind, count);
+    size_t i = 0;
+    try {
+      for (; i < count; ++i) Construct(p + i, tmp);
+    } catch (...) {
+      CloseGap(ind, count, i);
+      throw;
+    }
+    cur_size += count;
+    return iterator(array + ind, this);
+  }
+  /**
+   * inserts the elements of [first, last) before pos, moving the elements
+   * after pos only once and growing the storage at most once.
+   * returns an iterator pointing to the first inserted element (or pos if
+   * the range is empty).
+   * [first, last) must not refer to elements of this vector.
+   */
+  template <class InputIt, class = RequireIterator<InputIt>>
+  iterator insert(iterator pos, InputIt first, InputIt last) {
+    return insert(Index(pos), first, last);
+  }
+  template <class InputIt, class = RequireIterator<InputIt>>
+  iterator insert(const size_t &ind, InputIt first, InputIt last) {
     if (ind > cur_size) throw index_out_of_bound();
-    if (cur_size + 1 == limit) DoubleSpace();
-    for (int i = cur_size; i > ind; --i) array[i] = array[i - 1];
-    array[ind] = value, ++cur_size;
-    return iterator(ind, this);
+    if constexpr (std::is_same<Category<InputIt>,
+                               std::input_iterator_tag>::value) {
+      // 单遍迭代器无法预先求出长度，先收集到临时的 vector 中。
+      vector tmp(0, alloc);
+      for (; first != last; ++first) tmp.push_back(*first);
+      size_t n = tmp.cur_size;
+      T *p = OpenGap(ind, n);
+      if constexpr (is_trivially_relocatable<T>::value) {
+        Relocate(p, tmp.array, n);
+        NoteAdopt(tmp, n), tmp.cur_size = 0;
+      } else {
+        // 移动可能抛出异常时 Relocate 会退回拷贝，所以这里逐个构造，
+        // 失败时还能撤销；tmp 中的元素留给它自己析构。
+        size_t i = 0;
+        try {
+          for (; i < n; ++i)
+            Construct(p + i, std::move_if_noexcept(tmp.array[i]));
+        } catch (...) {
+          CloseGap(ind, n, i);
+          throw;
+        }
+      }
+      cur_size += n;
+    } else {
+      size_t n = Distance(first, last), i = 0;
+      T *p = OpenGap(ind, n);
+      try {
+        for (; first != last; ++first, ++i) Construct(p + i, *first);
+      } catch (...) {
+        CloseGap(ind, n, i);
+        throw;
+      }
+      cur_size += n;
+    }
+    return iterator(array + ind, this);
   }
   /**
    * removes the element at pos.
@@ -293,10 +920,9 @@ class vector {
    * returned.
    */
   iterator erase(iterator pos) {
-    array[pos.at].~T();
-    for (int i = pos.at; i < cur_size; ++i) array[i] = array[i + 1];
-    cur_size -= pos.at < cur_size;
-    return pos;
+    size_t ind = Index(pos);
+    if (ind < cur_size) ShiftLeft(ind);
+    return iterator(array + ind, this);
   }
   /**
    * removes the element with index ind.
@@ -305,17 +931,110 @@ class vector {
    */
   iterator erase(const size_t &ind) {
     if (ind >= cur_size) throw index_out_of_bound();
-    array[ind].~T();
-    for (int i = ind; i < cur_size; ++i) array[i] = array[i + 1];
-    --cur_size;
-    return iterator(ind, this);
+    ShiftLeft(ind);
+    return iterator(array + ind, this);
+  }
+  /**
+   * removes the elements in [first, last).
+   * return an iterator pointing to the element following the removed ones.
+   * throw invalid_iterator if [first, last) is not a valid range of this.
+   */
+  iterator erase(iterator first, iterator last) {
+    size_t l = Index(first), r = Index(last);
+    if (l > r) throw invalid_iterator();
+    if (l < r) ShiftLeft(l, r - l);
+    return iterator(array + l, this);
+  }
+  /**
+   * removes the element at pos in O(1) by moving the last element into its
+   * place; the order of the elements is not kept.
+   * returns an iterator pointing to the element now at pos (end() if pos
+   * was the last element).
+   */
+  iterator swap_erase(iterator pos) {
+    size_t ind = Index(pos);
+    if (ind == cur_size) throw invalid_iterator();
+    return swap_erase(ind);
+  }
+  /**
+   * throw index_out_of_bound if ind >= size
+   */
+  iterator swap_erase(const size_t &ind) {
+    if (ind >= cur_size) throw index_out_of_bound();
+    if (ind != cur_size - 1) array[ind] = std::move(array[cur_size - 1]);
+    Destroy(array + --cur_size);
+    return iterator(array + ind, this);
+  }
+  /**
+   * removes every element for which pred returns true, moving each kept
+   * element at most once; the order of the kept elements is preserved.
+   * returns the number of removed elements.
+   */
+  template <class Predicate>
+  size_t erase_if(Predicate pred) {
+    size_t w = 0;
+    while (w < cur_size && !pred(array[w])) ++w;
+    for (size_t r = w + 1; r < cur_size; ++r)
+      if (!pred(array[r])) array[w++] = std::move(array[r]);
+    size_t removed = cur_size - w;
+    while (cur_size > w) Destroy(array + --cur_size);
+    return removed;
+  }
+  /**
+   * removes the elements whose indices are listed in [first, last), in one
+   * sweep over the vector; the order of the kept elements is preserved.
+   * the indices must be strictly increasing.
+   * returns the number of removed elements.
+   * throw index_out_of_bound if an index >= size, or runtime_error if the
+   * indices are not strictly increasing; nothing is removed in both cases.
+   */
+  template <class ForwardIt, class = RequireIterator<ForwardIt>>
+  size_t erase_indices(ForwardIt first, ForwardIt last) {
+    if (first == last) return 0;
+    size_t prev = *first;
+    if (prev >= cur_size) throw index_out_of_bound();
+    for (ForwardIt it = std::next(first); it != last; ++it) {
+      if (size_t(*it) <= prev) throw runtime_error();
+      if ((prev = *it) >= cur_size) throw index_out_of_bound();
+    }
+    size_t w = *first, r = w;
+    for (; first != last; ++first) {
+      for (; r < size_t(*first); ++r) array[w++] = std::move(array[r]);
+      r = size_t(*first) + 1;
+    }
+    for (; r < cur_size; ++r) array[w++] = std::move(array[r]);
+    size_t removed = cur_size - w;
+    while (cur_size > w) Destroy(array + --cur_size);
+    return removed;
   }
   /**
    * adds an element to the end.
    */
-  void push_back(const T &value) {
-    if (cur_size + 1 == limit) DoubleSpace();
-    new (array + cur_size) T(value), ++cur_size;
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+  /**
+   * constructs an element in place from args at the end.
+   * returns a reference to the new element.
+   */
+  template <class... Args>
+  T &emplace_back(Args &&...args) {
+    if (cur_size == limit) {
+      // 扩容会释放旧空间，参数可能引用其中的元素，先构造出来。
+      T tmp(std::forward<Args>(args)...);
+      Expand(cur_size + 1);
+      Construct(array + cur_size, std::move(tmp));
+    } else {
+      Construct(array + cur_size, std::forward<Args>(args)...);
+    }
+    return array[cur_size++];
+  }
+  /**
+   * adds the elements of [first, last) to the end, growing the storage at
+   * most once.
+   */
+  template <class InputIt, class = RequireIterator<InputIt>>
+  void append(InputIt first, InputIt last) {
+    insert(cur_size, first, last);
   }
   /**
    * remove the last element from the end.
@@ -323,10 +1042,12 @@ class vector {
    */
   void pop_back() {
     if (!cur_size) throw container_is_empty();
-    array[--cur_size].~T();
+    Destroy(array + --cur_size);
   }
 };
 
 }  // namespace sjtu
 
+#include "vector_bool.hpp"
+
 #endif
\ No newline at end of file
@@ -0,0 +1,422 @@
+#ifndef SJTU_VECTOR_BOOL_HPP
+#define SJTU_VECTOR_BOOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a bit-packed vector<bool>: 64 flags per word, in a vector of words that
+ * uses the same (rebound) allocator and growth policy.
+ * elements are accessed through proxy references, as with std::vector<bool>.
+ * bits past size() are kept zero, so the bulk operations work on whole
+ * words: count() by popcount, find_first() / find_next() by
+ * count-trailing-zeros, and &=, |=, ^= by plain word loops the compiler
+ * turns into SIMD code.
+ */
+template <class Allocator, class Growth>
+class vector<bool, Allocator, Growth> {
+  using word = uint64_t;
+  static constexpr size_t bits = 64;
+  using WordAlloc =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<word>;
+
+  vector<word, WordAlloc, Growth> words;
+  size_t cur_size = 0;
+
+  static size_t Words(size_t n) { return (n + bits - 1) / bits; }
+  static word Bit(size_t pos) { return word(1) << (pos % bits); }
+  // 清零 size() 之后的位，保持整词运算的前提。
+  void ClearTail() {
+    if (cur_size % bits) words[cur_size / bits] &= Bit(cur_size) - 1;
+  }
+  // [ind, size) 整体后移一位，腾出第 ind 位（调用前已有足够的词）。
+  void ShiftUp(size_t ind) {
+    word *w = words.data();
+    size_t wi = ind / bits;
+    for (size_t i = Words(cur_size + 1) - 1; i > wi; --i)
+      w[i] = w[i] << 1 | w[i - 1] >> (bits - 1);
+    word low = Bit(ind) - 1;
+    w[wi] = (w[wi] & low) | (w[wi] & ~low) << 1;
+  }
+  // [ind + 1, size) 整体前移一位，覆盖第 ind 位。
+  void ShiftDown(size_t ind) {
+    word *w = words.data();
+    size_t wi = ind / bits, nw = Words(cur_size);
+    word low = Bit(ind) - 1;
+    w[wi] = (w[wi] & low) | (w[wi] >> 1 & ~low);
+    for (size_t i = wi + 1; i < nw; ++i)
+      w[i - 1] |= (w[i] & 1) << (bits - 1), w[i] >>= 1;
+  }
+  // 从 pos 所在的词开始找第一个置位的位，mask 屏蔽该词中 pos 之前的位。
+  size_t Find(size_t pos) const {
+    if (pos >= cur_size) return cur_size;
+    const word *w = words.data();
+    size_t i = pos / bits, nw = Words(cur_size);
+    word cur = w[i] & ~(Bit(pos) - 1);
+    while (!cur) {
+      if (++i == nw) return cur_size;
+      cur = w[i];
+    }
+    return i * bits + __builtin_ctzll(cur);
+  }
+  static size_t Popcount(const word *w, size_t nw) {
+    size_t ret = 0;
+    for (size_t i = 0; i < nw; ++i) ret += __builtin_popcountll(w[i]);
+    return ret;
+  }
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  // 默认目标下 __builtin_popcountll 是查表的库函数，支持时改用 popcnt 指令。
+  __attribute__((target("popcnt"), flatten)) static size_t PopcountHw(
+      const word *w, size_t nw) {
+    return Popcount(w, nw);
+  }
+#endif
+  void CheckSize(const vector &other) const {
+    if (other.cur_size != cur_size) throw runtime_error();
+  }
+
+ public:
+  using value_type = bool;
+
+  /**
+   * a proxy standing for one bit.
+   */
+  class reference {
+    friend class vector;
+
+    word *w;
+    word mask;
+
+    reference(word *w, word mask) : w(w), mask(mask) {}
+
+   public:
+    operator bool() const { return *w & mask; }
+    reference &operator=(bool value) {
+      value ? *w |= mask : *w &= ~mask;
+      return *this;
+    }
+    reference &operator=(const reference &other) {
+      return *this = bool(other);
+    }
+    void flip() { *w ^= mask; }
+    friend void swap(reference a, reference b) {
+      bool tmp = a;
+      a = bool(b), b = tmp;
+    }
+  };
+
+  /**
+   * index based random access iterators; * yields a reference proxy.
+   */
+  class const_iterator;
+  class iterator {
+    friend class vector;
+    friend class const_iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = bool;
+    using pointer = void;
+    using reference = typename vector::reference;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    vector *source{nullptr};
+
+    iterator(size_t at, vector *source) : at(at), source(source) {}
+
+   public:
+    iterator() = default;
+
+    iterator operator+(const difference_type &n) const {
+      return iterator(at + n, source);
+    }
+    friend iterator operator+(const difference_type &n, const iterator &it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type &n) const {
+      return iterator(at - n, source);
+    }
+    // if these two iterators point to different vectors, throw
+    // invaild_iterator.
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    iterator &operator+=(const difference_type &n) { return at += n, *this; }
+    iterator &operator-=(const difference_type &n) { return at -= n, *this; }
+
+    iterator operator++(int) { return iterator(at++, source); }
+    iterator &operator++() { return ++at, *this; }
+    iterator operator--(int) { return iterator(at--, source); }
+    iterator &operator--() { return --at, *this; }
+
+    reference operator*() const {
+      return reference(source->words.data() + at / bits, Bit(at));
+    }
+    reference operator[](const difference_type &n) const {
+      return *(*this + n);
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+  class const_iterator {
+    friend class vector;
+    friend class iterator;
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = bool;
+    using pointer = void;
+    using reference = bool;
+    using iterator_category = std::random_access_iterator_tag;
+
+   private:
+    size_t at{0};
+    const vector *source{nullptr};
+
+    const_iterator(size_t at, const vector *source) : at(at), source(source) {}
+
+   public:
+    const_iterator() = default;
+    const_iterator(const iterator &other)
+        : at(other.at), source(other.source) {}
+
+    const_iterator operator+(const difference_type &n) const {
+      return const_iterator(at + n, source);
+    }
+    friend const_iterator operator+(const difference_type &n,
+                                    const const_iterator &it) {
+      return it + n;
+    }
+    const_iterator operator-(const difference_type &n) const {
+      return const_iterator(at - n, source);
+    }
+    difference_type operator-(const const_iterator &rhs) const {
+      if (source != rhs.source) throw invalid_iterator();
+      return difference_type(at) - difference_type(rhs.at);
+    }
+    const_iterator &operator+=(const difference_type &n) {
+      return at += n, *this;
+    }
+    const_iterator &operator-=(const difference_type &n) {
+      return at -= n, *this;
+    }
+
+    const_iterator operator++(int) { return const_iterator(at++, source); }
+    const_iterator &operator++() { return ++at, *this; }
+    const_iterator operator--(int) { return const_iterator(at--, source); }
+    const_iterator &operator--() { return --at, *this; }
+
+    bool operator*() const {
+      return source->words.data()[at / bits] & Bit(at);
+    }
+    bool operator[](const difference_type &n) const { return *(*this + n); }
+
+    bool operator==(const const_iterator &rhs) const {
+      return source == rhs.source && at == rhs.at;
+    }
+    bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+    bool operator<(const const_iterator &rhs) const { return at < rhs.at; }
+    bool operator>(const const_iterator &rhs) const { return at > rhs.at; }
+    bool operator<=(const const_iterator &rhs) const { return at <= rhs.at; }
+    bool operator>=(const const_iterator &rhs) const { return at >= rhs.at; }
+  };
+
+  // cnt 为初始申请的空间大小（以位计）。
+  vector(int cnt = 0, const Allocator &alloc = Allocator())
+      : words(int(Words(cnt)), WordAlloc(alloc)) {}
+  explicit vector(const Allocator &alloc) : vector(0, alloc) {}
+  vector(const vector &) = default;
+  vector(vector &&other) noexcept(
+      std::allocator_traits<WordAlloc>::is_always_equal::value)
+      : words(std::move(other.words)), cur_size(other.cur_size) {
+    other.cur_size = 0;
+  }
+
+  vector &operator=(const vector &) = default;
+  vector &operator=(vector &&other) noexcept(
+      noexcept(words = std::move(other.words))) {
+    if (&other != this) {
+      words = std::move(other.words);
+      cur_size = other.cur_size, other.cur_size = 0;
+    }
+    return *this;
+  }
+
+  Allocator get_allocator() const { return Allocator(words.get_allocator()); }
+
+  reference at(const size_t &pos) {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return reference(words.data() + pos / bits, Bit(pos));
+  }
+  bool at(const size_t &pos) const {
+    if (pos >= cur_size) throw index_out_of_bound();
+    return words.data()[pos / bits] & Bit(pos);
+  }
+  reference operator[](const size_t &pos) { return at(pos); }
+  bool operator[](const size_t &pos) const { return at(pos); }
+
+  bool front() const {
+    if (!cur_size) throw container_is_empty();
+    return at(0);
+  }
+  bool back() const {
+    if (!cur_size) throw container_is_empty();
+    return at(cur_size - 1);
+  }
+
+  iterator begin() { return iterator(0, this); }
+  const_iterator begin() const { return const_iterator(0, this); }
+  const_iterator cbegin() const { return const_iterator(0, this); }
+  iterator end() { return iterator(cur_size, this); }
+  const_iterator end() const { return const_iterator(cur_size, this); }
+  const_iterator cend() const { return const_iterator(cur_size, this); }
+  /**
+   * the packed words; bit i is bit i % 64 of word i / 64.
+   * bits at and past size() must stay zero when writing through them.
+   */
+  word *word_data() { return words.data(); }
+  const word *word_data() const { return words.data(); }
+
+  bool empty() const { return !cur_size; }
+  size_t size() const { return cur_size; }
+  size_t capacity() const { return words.capacity() * bits; }
+  void reserve(const size_t &n) { words.reserve(Words(n)); }
+  void shrink_to_fit() { words.shrink_to_fit(); }
+
+  void resize(const size_t &n, bool value = false) {
+    if (n <= cur_size) {
+      words.resize(Words(n));
+      cur_size = n;
+      return ClearTail();
+    }
+    if (value && cur_size % bits)
+      words[cur_size / bits] |= ~(Bit(cur_size) - 1);
+    words.resize(Words(n), value ? ~word(0) : word(0));
+    cur_size = n;
+    ClearTail();
+  }
+  void clear() { words.clear(), cur_size = 0; }
+
+  /**
+   * inserts value at index ind.
+   * throw index_out_of_bound if ind > size
+   */
+  iterator insert(const size_t &ind, bool value) {
+    if (ind > cur_size) throw index_out_of_bound();
+    if (Words(cur_size + 1) > words.size()) words.push_back(0);
+    ShiftUp(ind);
+    ++cur_size;
+    at(ind) = value;
+    return iterator(ind, this);
+  }
+  iterator insert(iterator pos, bool value) {
+    if (pos.source != this || pos.at > cur_size) throw invalid_iterator();
+    return insert(pos.at, value);
+  }
+  /**
+   * removes the element with index ind.
+   * throw index_out_of_bound if ind >= size
+   */
+  iterator erase(const size_t &ind) {
+    if (ind >= cur_size) throw index_out_of_bound();
+    ShiftDown(ind);
+    if (Words(--cur_size) < words.size()) words.pop_back();
+    return iterator(ind, this);
+  }
+  iterator erase(iterator pos) {
+    if (pos.source != this || pos.at > cur_size) throw invalid_iterator();
+    return pos.at < cur_size ? erase(pos.at) : pos;
+  }
+
+  void push_back(bool value) {
+    if (cur_size % bits == 0) words.push_back(0);
+    if (value) words[cur_size / bits] |= Bit(cur_size);
+    ++cur_size;
+  }
+  /**
+   * throw container_is_empty if size() == 0
+   */
+  void pop_back() {
+    if (!cur_size) throw container_is_empty();
+    if (--cur_size % bits == 0)
+      words.pop_back();
+    else
+      ClearTail();
+  }
+
+  /**
+   * inverts every element.
+   */
+  void flip() {
+    word *w = words.data();
+    for (size_t i = 0, nw = words.size(); i < nw; ++i) w[i] = ~w[i];
+    ClearTail();
+  }
+  /**
+   * the number of elements that are true.
+   */
+  size_t count() const {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static const bool hw = __builtin_cpu_supports("popcnt");
+    if (hw) return PopcountHw(words.data(), words.size());
+#endif
+    return Popcount(words.data(), words.size());
+  }
+  /**
+   * the index of the first true element, or size() if there is none.
+   */
+  size_t find_first() const { return Find(0); }
+  /**
+   * the index of the first true element after pos, or size() if there is
+   * none.
+   */
+  size_t find_next(const size_t &pos) const {
+    return pos < cur_size ? Find(pos + 1) : cur_size;
+  }
+
+  /**
+   * element-wise AND / OR / XOR with a vector of the same size.
+   * throw runtime_error if the sizes differ.
+   */
+  vector &operator&=(const vector &rhs) {
+    CheckSize(rhs);
+    word *w = words.data();
+    const word *r = rhs.words.data();
+    for (size_t i = 0, nw = words.size(); i < nw; ++i) w[i] &= r[i];
+    return *this;
+  }
+  vector &operator|=(const vector &rhs) {
+    CheckSize(rhs);
+    word *w = words.data();
+    const word *r = rhs.words.data();
+    for (size_t i = 0, nw = words.size(); i < nw; ++i) w[i] |= r[i];
+    return *this;
+  }
+  vector &operator^=(const vector &rhs) {
+    CheckSize(rhs);
+    word *w = words.data();
+    const word *r = rhs.words.data();
+    for (size_t i = 0, nw = words.size(); i < nw; ++i) w[i] ^= r[i];
+    return *this;
+  }
+};
+
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,289 @@
+#ifndef SJTU_VECTOR_IO_HPP
+#define SJTU_VECTOR_IO_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "exceptions.hpp"
+#include "span.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+/**
+ * a versioned binary format for sjtu::vector.
+ *
+ * a 32-byte header (magic, format version, element size, element count,
+ * flags) is followed by the payload. trivially copyable elements are
+ * stored as one raw block in native byte order, so writing is a single
+ * write and reading goes straight into the vector's buffer, and a buffer
+ * or a mapped file holding the format can be viewed in place without
+ * copying anything. vector<bool> stores its packed 64-bit words the same
+ * way. other types go through serializer<T>, which users specialize;
+ * std::string and nested sjtu::vector are provided.
+ *
+ * malformed or truncated input and I/O failures throw runtime_error.
+ */
+namespace io {
+
+struct header {
+  char magic[8];
+  uint32_t version;
+  uint32_t elem_size;
+  uint64_t count;
+  uint32_t flags;
+  uint32_t reserved;
+};
+static_assert(sizeof(header) == 32, "unexpected header layout");
+
+constexpr char magic[8] = "SJTUVEC";
+constexpr uint32_t version = 1;
+constexpr uint32_t raw_block = 1;    // flags：载荷为原样的内存块。
+constexpr uint32_t packed_bits = 2;  // flags：载荷为 vector<bool> 的 64 位字。
+// 读入时每次最多追加的字节数。元素个数来自输入，不能一次按它申请空间，
+// 否则被损坏的头部就能骗去申请大量内存。
+constexpr size_t chunk = size_t(1) << 20;
+
+/**
+ * writes and reads one element of a type that is not trivially copyable:
+ *   static void write(std::ostream &os, const T &value);
+ *   static T read(std::istream &is);
+ */
+template <typename T, class = void>
+struct serializer;
+
+template <typename T>
+constexpr bool is_raw = std::is_trivially_copyable<T>::value;
+
+inline void Write(std::ostream &os, const void *p, size_t bytes) {
+  if (!os.write((const char *)p, bytes)) throw runtime_error();
+}
+inline void Read(std::istream &is, void *p, size_t bytes) {
+  if (!is.read((char *)p, bytes)) throw runtime_error();
+}
+template <typename T>
+header MakeHeader(size_t count) {
+  header h{};
+  memcpy(h.magic, magic, sizeof(magic));
+  h.version = version, h.elem_size = sizeof(T), h.count = count;
+  h.flags = is_raw<T> ? raw_block : 0;
+  return h;
+}
+template <typename T>
+void Check(const header &h, uint32_t flags = is_raw<T> ? raw_block : 0) {
+  if (memcmp(h.magic, magic, sizeof(magic)) || h.version != version ||
+      h.elem_size != sizeof(T) || h.flags != flags)
+    throw runtime_error();
+}
+
+template <typename T, class A, class G>
+void save(std::ostream &os, const vector<T, A, G> &v) {
+  header h = MakeHeader<T>(v.size());
+  Write(os, &h, sizeof(h));
+  if constexpr (is_raw<T>) {
+    if (v.size()) Write(os, v.data(), v.size() * sizeof(T));
+  } else {
+    for (size_t i = 0; i < v.size(); ++i) serializer<T>::write(os, v[i]);
+  }
+}
+/**
+ * replaces the contents of v with a vector written by save().
+ * raw payloads are read straight into the buffer of v, at most 1 MiB per
+ * call, and v grows only as the data arrives: a header claiming more
+ * elements than the stream holds fails at the end of the stream instead
+ * of allocating the claimed size up front.
+ */
+template <typename T, class A, class G>
+void load(std::istream &is, vector<T, A, G> &v) {
+  header h;
+  Read(is, &h, sizeof(h));
+  Check<T>(h);
+  if (h.count > SIZE_MAX / sizeof(T)) throw runtime_error();
+  v.clear();
+  if constexpr (is_raw<T>) {
+    const size_t step = chunk / sizeof(T) ? chunk / sizeof(T) : 1;
+    try {
+      for (size_t left = h.count; left;) {
+        size_t n = left < step ? left : step;
+        Read(is, v.append_uninitialized(n), n * sizeof(T));
+        left -= n;
+      }
+    } catch (...) {
+      v.clear();
+      throw;
+    }
+  } else {
+    // 同样不预先按数量申请空间。
+    for (size_t i = 0; i < h.count; ++i)
+      v.push_back(serializer<T>::read(is));
+  }
+}
+
+/**
+ * vector<bool> has no array of bool to write, so its packed words are
+ * stored instead: (size + 63) / 64 of them, in one write, and read back
+ * in chunks like a raw payload.
+ */
+template <class A, class G>
+void save(std::ostream &os, const vector<bool, A, G> &v) {
+  header h = MakeHeader<bool>(v.size());
+  h.flags = packed_bits;
+  Write(os, &h, sizeof(h));
+  if (v.size()) Write(os, v.word_data(), (v.size() + 63) / 64 * 8);
+}
+template <class A, class G>
+void load(std::istream &is, vector<bool, A, G> &v) {
+  header h;
+  Read(is, &h, sizeof(h));
+  Check<bool>(h, packed_bits);
+  v.clear();
+  if (!h.count) return;
+  size_t words = (h.count - 1) / 64 + 1;
+  if (words > SIZE_MAX / 8) throw runtime_error();
+  const size_t step = chunk * 8;  // 每块的位数，是 64 的倍数。
+  try {
+    for (size_t done = 0; done < h.count;) {
+      size_t n = h.count - done < step ? h.count - done : step;
+      v.resize(done + n);
+      Read(is, v.word_data() + done / 64, (n + 63) / 64 * 8);
+      done += n;
+    }
+    // 最后一个字中 size() 之后的位必须为 0.
+    if (h.count % 64 && v.word_data()[words - 1] >> h.count % 64)
+      throw runtime_error();
+  } catch (...) {
+    v.clear();
+    throw;
+  }
+}
+
+/**
+ * a view of the elements of a vector saved in the buffer [buf, buf + bytes).
+ * the buffer must hold the whole payload and be aligned for T.
+ */
+template <typename T>
+span<const T> view(const void *buf, size_t bytes) {
+  static_assert(is_raw<T>, "only trivially copyable elements can be viewed");
+  header h;
+  if (bytes < sizeof(h)) throw runtime_error();
+  memcpy(&h, buf, sizeof(h));
+  Check<T>(h);
+  const char *payload = (const char *)buf + sizeof(h);
+  if (h.count > (bytes - sizeof(h)) / sizeof(T) ||
+      (uintptr_t)payload % alignof(T))
+    throw runtime_error();
+  return span<const T>((const T *)payload, h.count);
+}
+
+/**
+ * a file written by save() mapped read-only, its elements viewed in place.
+ * pages are loaded on first access; nothing is copied.
+ */
+template <typename T>
+class mapped_view {
+  void *base{nullptr};
+  size_t bytes{0};
+  span<const T> elems;
+
+  void Close() {
+    if (base) munmap(base, bytes);
+    base = nullptr, bytes = 0, elems = span<const T>();
+  }
+
+ public:
+  mapped_view() = default;
+  explicit mapped_view(const char *path) { open(path); }
+  mapped_view(const mapped_view &) = delete;
+  mapped_view(mapped_view &&other) noexcept
+      : base(other.base), bytes(other.bytes), elems(other.elems) {
+    other.base = nullptr, other.bytes = 0, other.elems = span<const T>();
+  }
+  ~mapped_view() { Close(); }
+
+  mapped_view &operator=(const mapped_view &) = delete;
+  mapped_view &operator=(mapped_view &&other) noexcept {
+    if (&other != this) {
+      Close();
+      base = other.base, bytes = other.bytes, elems = other.elems;
+      other.base = nullptr, other.bytes = 0, other.elems = span<const T>();
+    }
+    return *this;
+  }
+
+  void open(const char *path) {
+    Close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) throw runtime_error();
+    struct stat st;
+    if (fstat(fd, &st) || size_t(st.st_size) < sizeof(header)) {
+      ::close(fd);
+      throw runtime_error();
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // 映射建立后不再需要文件描述符。
+    if (p == MAP_FAILED) throw runtime_error();
+    base = p, bytes = st.st_size;
+    try {
+      elems = view<T>(base, bytes);
+    } catch (...) {
+      Close();
+      throw;
+    }
+  }
+
+  span<const T> get() const { return elems; }
+  const T &at(const size_t &pos) const { return elems.at(pos); }
+  const T &operator[](const size_t &pos) const { return elems.at(pos); }
+  const T *begin() const { return elems.begin(); }
+  const T *end() const { return elems.end(); }
+  const T *data() const { return elems.data(); }
+  size_t size() const { return elems.size(); }
+  bool empty() const { return elems.empty(); }
+};
+
+template <>
+struct serializer<std::string> {
+  static void write(std::ostream &os, const std::string &s) {
+    uint64_t len = s.size();
+    Write(os, &len, sizeof(len));
+    Write(os, s.data(), len);
+  }
+  static std::string read(std::istream &is) {
+    uint64_t len;
+    Read(is, &len, sizeof(len));
+    std::string s;
+    // 同样不直接按输入中的长度申请空间，分段读入。
+    for (char buf[4096]; len;) {
+      size_t n = len < sizeof(buf) ? len : sizeof(buf);
+      Read(is, buf, n);
+      s.append(buf, n), len -= n;
+    }
+    return s;
+  }
+};
+
+template <typename T, class A, class G>
+struct serializer<vector<T, A, G>> {
+  static void write(std::ostream &os, const vector<T, A, G> &v) {
+    save(os, v);
+  }
+  static vector<T, A, G> read(std::istream &is) {
+    vector<T, A, G> v;
+    load(is, v);
+    return v;
+  }
+};
+
+}  // namespace io
+}  // namespace sjtu
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef SJTU_VECTOR_STATS_HPP
+#define SJTU_VECTOR_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <typeinfo>
+
+namespace sjtu {
+/**
+ * memory counters of sjtu::vector, collected only when SJTU_VECTOR_STATS is
+ * defined before vector.hpp is included (otherwise none of this code is
+ * compiled into vector and it costs nothing).
+ * vector::stats() gives the counters of one vector; type_stats::of<T>()
+ * accumulates them over every vector of element type T (in any thread),
+ * and dump_vector_stats() reports every element type seen so far.
+ */
+struct vector_stats {
+  size_t reallocations = 0;  // 换到新缓冲区（或 realloc）的次数。
+  size_t bytes_moved = 0;    // 扩容时搬动的元素字节数。
+  size_t peak_capacity = 0;  // 以字节计。
+  size_t slack = 0;          // 已申请但未存放元素的字节数。
+  size_t constructions = 0;
+  size_t destructions = 0;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const vector_stats &s) {
+  return os << "reallocations=" << s.reallocations
+            << " bytes_moved=" << s.bytes_moved
+            << " peak_capacity=" << s.peak_capacity << " slack=" << s.slack
+            << " constructions=" << s.constructions
+            << " destructions=" << s.destructions;
+}
+
+/**
+ * the counters of all vectors of one element type; thread safe.
+ */
+class type_stats {
+  const char *type_name;
+  size_t elem_size;
+  type_stats *next;
+  std::atomic<size_t> capacity{0};  // 所有 vector 当前申请的总字节数。
+
+  static std::mutex &Lock() {
+    static std::mutex m;
+    return m;
+  }
+  static type_stats *&Head() {
+    static type_stats *head = nullptr;
+    return head;
+  }
+
+  type_stats(const char *type_name, size_t elem_size)
+      : type_name(type_name), elem_size(elem_size) {
+    std::lock_guard<std::mutex> lk(Lock());
+    next = Head(), Head() = this;
+  }
+
+ public:
+  std::atomic<size_t> reallocations{0}, bytes_moved{0}, peak_capacity{0};
+  std::atomic<size_t> constructions{0}, destructions{0};
+
+  template <typename T>
+  static type_stats &of() {
+    static type_stats s(typeid(T).name(), sizeof(T));
+    return s;
+  }
+  template <class F>
+  static void for_each(F &&f) {
+    std::lock_guard<std::mutex> lk(Lock());
+    for (type_stats *s = Head(); s; s = s->next) f(*s);
+  }
+
+  void allocated(size_t bytes) {
+    size_t now = capacity += bytes, peak = peak_capacity;
+    while (now > peak && !peak_capacity.compare_exchange_weak(peak, now)) {
+    }
+  }
+  void deallocated(size_t bytes) { capacity -= bytes; }
+
+  /**
+   * the mangled name of the element type, from typeid.
+   */
+  const char *name() const { return type_name; }
+  vector_stats get() const {
+    vector_stats s;
+    s.reallocations = reallocations, s.bytes_moved = bytes_moved;
+    s.peak_capacity = peak_capacity;
+    s.constructions = constructions, s.destructions = destructions;
+    size_t live = (s.constructions - s.destructions) * elem_size;
+    s.slack = capacity > live ? capacity - live : 0;
+    return s;
+  }
+};
+
+/**
+ * calls hook(name, stats) for every element type used with vector so far,
+ * e.g. to send the counters to a production logger.
+ */
+inline void dump_vector_stats(void (*hook)(const char *name,
+                                           const vector_stats &stats)) {
+  type_stats::for_each([hook](const type_stats &s) { hook(s.name(), s.get()); });
+}
+/**
+ * writes one line per element type to os.
+ */
+inline void dump_vector_stats(std::ostream &os) {
+  type_stats::for_each([&os](const type_stats &s) {
+    os << "vector<" << s.name() << "> " << s.get() << '\n';
+  });
+}
+
+}  // namespace sjtu
+
+#endif
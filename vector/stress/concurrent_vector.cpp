@@ -0,0 +1,131 @@
+// multi-producer stress test of concurrent_vector: several threads push at
+// once while readers poll published elements. checks that every element
+// lands exactly once at the index push_back returned, that readers never
+// see a half-built element, that exactly one copy of each segment stays
+// installed (a thread losing the install race frees its copy), and that
+// the destructor destroys every element.
+//   g++ -std=c++17 -O2 -pthread -I../src concurrent_vector.cpp -o cv && ./cv
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.hpp"
+
+#define CHECK(cond)                                           \
+  do {                                                        \
+    if (!(cond)) {                                            \
+      std::printf("%s:%d: check failed: %s\n", __FILE__,      \
+                  __LINE__, #cond);                           \
+      std::exit(1);                                           \
+    }                                                         \
+  } while (0)
+
+// 只有 concurrent_vector 的段用 new[] 分配，借此数出分配与释放了几次。
+// 不让它们内联，免得编译器把 malloc/free 与 new[]/delete[] 当成不配对。
+static std::atomic<size_t> array_news{0}, array_deletes{0};
+__attribute__((noinline)) void *operator new[](size_t n) {
+  ++array_news;
+  if (void *p = std::malloc(n)) return p;
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete[](void *p) noexcept {
+  ++array_deletes;
+  std::free(p);
+}
+void operator delete[](void *p, size_t) noexcept { operator delete[](p); }
+
+static std::atomic<long> live{0};
+
+struct Item {
+  uint32_t thread, seq;
+  uint64_t check;
+
+  Item(uint32_t thread, uint32_t seq)
+      : thread(thread), seq(seq), check(Mix(thread, seq)) {
+    ++live;
+  }
+  Item(const Item &other) : thread(other.thread), seq(other.seq),
+                            check(other.check) {
+    ++live;
+  }
+  ~Item() { --live; }
+
+  static uint64_t Mix(uint64_t a, uint64_t b) {
+    uint64_t x = a << 32 | b;
+    x ^= x >> 33, x *= 0xff51afd7ed558ccdULL, x ^= x >> 33;
+    return x;
+  }
+  bool intact() const { return check == Mix(thread, seq); }
+};
+
+int main() {
+  const unsigned producers = 8, readers = 2;
+  const uint32_t per_thread = 200000;
+  const size_t first_size = 4;  // 段很小，跨段的竞争更频繁。
+  {
+    sjtu::concurrent_vector<Item, first_size> v;
+    std::vector<std::vector<size_t>> where(producers);
+    std::atomic<bool> done{false};
+    std::atomic<size_t> seen{0};
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < producers; ++t) {
+      threads.emplace_back([&, t] {
+        where[t].reserve(per_thread);
+        for (uint32_t i = 0; i < per_thread; ++i)
+          where[t].push_back(i % 2 ? v.push_back(Item(t, i))
+                                   : v.emplace_back(t, i));
+      });
+    }
+    for (unsigned r = 0; r < readers; ++r) {
+      threads.emplace_back([&, r] {
+        std::mt19937_64 rng(r);
+        size_t local = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+          size_t n = v.size();
+          if (!n) continue;
+          size_t pos = rng() % n;
+          if (!v.is_published(pos)) continue;
+          const Item &item = v[pos];
+          CHECK(item.intact() && item.thread < producers);
+          ++local;
+        }
+        seen += local;
+      });
+    }
+    for (unsigned t = 0; t < producers; ++t) threads[t].join();
+    done = true;
+    for (unsigned r = 0; r < readers; ++r) threads[producers + r].join();
+
+    size_t n = size_t(producers) * per_thread;
+    CHECK(v.size() == n);
+    std::vector<bool> used(n);
+    for (unsigned t = 0; t < producers; ++t) {
+      for (uint32_t i = 0; i < per_thread; ++i) {
+        size_t pos = where[t][i];
+        CHECK(pos < n && !used[pos]);
+        used[pos] = true;
+        CHECK(v.is_published(pos));
+        CHECK(v[pos].thread == t && v[pos].seq == i && v[pos].intact());
+      }
+    }
+    CHECK(live == long(n));
+
+    // 段 k 覆盖 [first_size * (2^k - 1), first_size * (2^(k+1) - 1))，
+    // 最后一段过半时可能已提前装好下一段；竞争失败的副本已经释放。
+    size_t segments = 0;
+    while (first_size * ((size_t(1) << segments) - 1) < n) ++segments;
+    size_t installed = array_news - array_deletes;
+    CHECK(installed == segments || installed == segments + 1);
+    std::printf("ok: %zu elements, %zu segments, %zu lost install races, "
+                "%zu reads\n",
+                n, installed, array_deletes.load(), seen.load());
+  }
+  CHECK(live == 0);
+  return 0;
+}
@@ -0,0 +1,61 @@
+// randomized check of soa_vector against a std::vector of tuples, with a
+// bool field to cover the byte-wide storage of bool columns.
+//   g++ -std=c++17 -O2 -I../src soa_vector.cpp -o soa_vector && ./soa_vector
+#include <cstdio>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "soa_vector.hpp"
+
+#define CHECK(cond)                                           \
+  do {                                                        \
+    if (!(cond)) {                                            \
+      std::printf("%s:%d: check failed: %s\n", __FILE__,      \
+                  __LINE__, #cond);                           \
+      return 1;                                               \
+    }                                                         \
+  } while (0)
+
+int main() {
+  using Row = std::tuple<int, bool, std::string>;
+  sjtu::soa_vector<int, bool, std::string> v;
+  std::vector<Row> ref;
+  std::mt19937 rng(2024);
+  for (int step = 0; step < 200000; ++step) {
+    unsigned op = rng() % 10;
+    if (op < 6 || ref.empty()) {
+      int x = rng() % 1000;
+      Row r(x, x % 3 == 0, std::to_string(x));
+      if (op % 2)
+        v.push_back(r);
+      else
+        v.emplace_back(std::get<0>(r), std::get<1>(r), std::get<2>(r));
+      ref.push_back(r);
+    } else if (op < 8) {
+      size_t i = rng() % ref.size();
+      v.erase(i);
+      ref.erase(ref.begin() + i);
+    } else if (op < 9) {
+      v.pop_back();
+      ref.pop_back();
+    } else {
+      size_t i = rng() % ref.size();
+      v[i].get<1>() = !v[i].get<1>();
+      std::get<1>(ref[i]) = !std::get<1>(ref[i]);
+    }
+  }
+  CHECK(v.size() == ref.size());
+  auto flags = v.column<1>();
+  size_t set = 0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    CHECK(Row(v.at(i)) == ref[i]);
+    CHECK(flags[i] == std::get<1>(ref[i]));
+    set += flags[i];
+  }
+  size_t i = 0;
+  for (auto row : v) CHECK(row.get<0>() == std::get<0>(ref[i++]));
+  std::printf("ok: %zu rows, %zu flags set\n", ref.size(), set);
+  return 0;
+}